@@ -0,0 +1,489 @@
+/*
+ * Implementation of the table interface as a move-to-front list stored
+ * in one contiguous array instead of a dlist. The front of the list is
+ * the END of the array, so a new entry is simply appended and a hit in
+ * table_lookup() is moved to the front by shifting the entries after
+ * it one step with memmove(). Lookups scan the array from the end,
+ * which finds the latest inserted value of a duplicate key first.
+ *
+ * No memory is allocated on the lookup path, and a scan walks
+ * contiguous memory instead of following list pointers.
+ *
+ * How far a hit is moved is decided by the policy given to
+ * table_empty_policy(), see arraymtftable.h. Only the entry that is
+ * hit ever moves forward, so a newer duplicate always stays in front
+ * of an older one whatever the policy.
+ *
+ * With POLICY_COUNT the counts never increase from the front of the
+ * list to the back. A new entry is put in front of all entries with
+ * its count (0, or the count of the duplicate it hides) and behind all
+ * entries with a higher count, and a hit is moved in front of all
+ * entries with its new count. For example, after inserting A, B and C
+ * and looking up A, A, B, C, C, C the list is C(3) A(2) B(1), and a
+ * new entry D is put last, as D(0).
+ *
+ * Authors: Adam Pettersson
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first public version.
+ *   2026-10-16: v1.1, added the transpose, count and move-ahead-k
+ *		 policies.
+ *   2026-10-16: v1.2, POLICY_COUNT keeps the list in count order on
+ *		 insert.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "table.h"
+#include "arraymtftable.h"
+
+// Number of entries a new table has room for. The array is doubled
+// when it is full and halved when less than a quarter is used.
+#define INITIAL_CAPACITY 16
+
+// count is the number of times the entry has been found by
+// table_lookup(). It is only used by POLICY_COUNT.
+struct table_entry {
+	void *key;
+	void *value;
+	unsigned int count;
+};
+
+// entries holds size entries in an array with room for capacity
+// entries. entries[size - 1] is the front of the list. The array is
+// never shrunk below min_capacity, set by table_reserve().
+struct table {
+	struct table_entry *entries;
+	int size;
+	int capacity;
+	int min_capacity;
+	table_policy policy;
+	int k;
+	compare_function *key_cmp_func;
+	free_function key_free_func;
+	free_function value_free_func;
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * set_capacity() - Reallocate the entry array.
+ * @t: Table to manipulate.
+ * @capacity: Number of entries the array should have room for.
+ *
+ * Returns: Nothing.
+ */
+static void set_capacity(table *t, int capacity)
+{
+	t->entries = realloc(t->entries, capacity * sizeof(struct table_entry));
+	t->capacity = capacity;
+}
+
+/**
+ * move_entry() - Move an entry towards the front of the list.
+ * @t: Table to manipulate.
+ * @from: Position of the entry in the array.
+ * @to: New position of the entry, from <= to < size.
+ *
+ * The entries between from and to are shifted one step back.
+ *
+ * Returns: Nothing.
+ */
+static void move_entry(const table *t, int from, int to)
+{
+	struct table_entry hit = t->entries[from];
+
+	memmove(&t->entries[from], &t->entries[from + 1],
+		(to - from) * sizeof(struct table_entry));
+	t->entries[to] = hit;
+}
+
+/**
+ * reorganize() - Move a found entry according to the table policy.
+ * @t: Table to manipulate.
+ * @pos: Position of the entry found by table_lookup().
+ *
+ * Returns: Nothing.
+ */
+static void reorganize(const table *t, int pos)
+{
+	int front = t->size - 1;
+	int to = front;
+
+	switch (t->policy) {
+	case POLICY_MOVE_TO_FRONT:
+		to = front;
+		break;
+	case POLICY_TRANSPOSE:
+		to = pos < front ? pos + 1 : pos;
+		break;
+	case POLICY_MOVE_AHEAD:
+		to = pos + t->k < front ? pos + t->k : front;
+		break;
+	case POLICY_COUNT:
+		// Pass all entries in front that have not been found
+		// more often than this one.
+		t->entries[pos].count++;
+		to = pos;
+		while (to < front && t->entries[to + 1].count <= t->entries[pos].count) {
+			to++;
+		}
+		break;
+	}
+
+	move_entry(t, pos, to);
+}
+
+/**
+ * insert_position() - Find where a new entry goes with POLICY_COUNT.
+ * @t: Table to inspect.
+ * @key: Key of the new entry.
+ * @count: Set to the count the new entry starts with.
+ *
+ * The new entry gets the count of the front-most duplicate of key, so
+ * that it stays in front of the duplicate and hides it, or 0 if there
+ * is no duplicate.
+ *
+ * Returns: The position of the first entry with a higher count than
+ * *count, or size if there is none.
+ */
+static int insert_position(const table *t, const void *key, unsigned int *count)
+{
+	*count = 0;
+	for (int pos = t->size - 1; pos >= 0; pos--) {
+		if (t->key_cmp_func(t->entries[pos].key, key) == 0) {
+			*count = t->entries[pos].count;
+			break;
+		}
+	}
+
+	// The counts never decrease towards the end of the array, so the
+	// position can be found by binary search.
+	int low = 0;
+	int high = t->size;
+	while (low < high) {
+		int mid = low + (high - low) / 2;
+		if (t->entries[mid].count > *count) {
+			high = mid;
+		} else {
+			low = mid + 1;
+		}
+	}
+
+	return low;
+}
+
+// ===========PUBLIC FUNCTION IMPLEMENTATIONS============
+
+/**
+ * table_empty_policy() - Create an empty self-organizing table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @policy: How entries are moved when found by table_lookup().
+ * @k: Number of steps for POLICY_MOVE_AHEAD. Ignored for the other
+ *     policies.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_policy(compare_function *key_cmp_func,
+			  table_policy policy, int k,
+			  free_function key_free_func,
+			  free_function value_free_func)
+{
+	// Allocate the table header.
+	table *t = calloc(1, sizeof(table));
+	// Create a small array to hold the table entries.
+	t->entries = malloc(INITIAL_CAPACITY * sizeof(struct table_entry));
+	t->capacity = INITIAL_CAPACITY;
+	t->min_capacity = INITIAL_CAPACITY;
+	// Store the policy.
+	t->policy = policy;
+	t->k = k > 0 ? k : 1;
+	// Store the key compare function and key/value free functions.
+	t->key_cmp_func = key_cmp_func;
+	t->key_free_func = key_free_func;
+	t->value_free_func = value_free_func;
+
+	return t;
+}
+
+/**
+ * table_empty() - Create an empty table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table using POLICY_MOVE_TO_FRONT.
+ */
+table *table_empty(compare_function *key_cmp_func,
+		   free_function key_free_func,
+		   free_function value_free_func)
+{
+	return table_empty_policy(key_cmp_func, POLICY_MOVE_TO_FRONT, 1,
+				  key_free_func, value_free_func);
+}
+
+/**
+ * table_is_empty() - Check if a table is empty.
+ * @table: Table to check.
+ *
+ * Returns: True if table contains no key/value pairs, false otherwise.
+ */
+bool table_is_empty(const table *t)
+{
+	return t->size == 0;
+}
+
+/**
+ * table_size() - Return the number of entries in a table.
+ * @t: Table to inspect.
+ *
+ * Returns: The number of key/value pairs in the table.
+ */
+int table_size(const table *t)
+{
+	return t->size;
+}
+
+/**
+ * table_insert() - Add a key/value pair to a table.
+ * @table: Table to manipulate.
+ * @key: A pointer to the key value.
+ * @value: A pointer to the value value.
+ *
+ * Insert the key/value pair into the table. No test is performed to
+ * check if key is a duplicate. table_lookup() will return the latest
+ * added value for a duplicate key. table_remove() will remove all
+ * duplicates for a given key.
+ *
+ * Returns: Nothing.
+ */
+void table_insert(table *t, void *key, void *value)
+{
+	if (t->size == t->capacity) {
+		set_capacity(t, t->capacity * 2);
+	}
+
+	// Append the pair, which puts it first in the list. This will
+	// cause table_lookup() to find the latest added value. With
+	// POLICY_COUNT the pair is put behind the entries with a higher
+	// count instead, which are all in front of any duplicate.
+	int pos = t->size;
+	unsigned int count = 0;
+	if (t->policy == POLICY_COUNT) {
+		pos = insert_position(t, key, &count);
+		memmove(&t->entries[pos + 1], &t->entries[pos],
+			(t->size - pos) * sizeof(struct table_entry));
+	}
+	t->entries[pos].key = key;
+	t->entries[pos].value = value;
+	t->entries[pos].count = count;
+	t->size++;
+}
+
+/**
+ * table_insert_many() - Add a batch of key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n pointers to key values.
+ * @values: Array of n pointers to value values.
+ * @n: Number of pairs.
+ *
+ * The pairs are inserted one at a time in array order, so that a later
+ * duplicate in the batch hides an earlier one.
+ *
+ * Returns: Nothing.
+ */
+void table_insert_many(table *t, void *const *keys, void *const *values, int n)
+{
+	for (int i = 0; i < n; i++) {
+		table_insert(t, keys[i], values[i]);
+	}
+}
+
+/**
+ * table_lookup() - Look up a given key in a table.
+ * @table: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The value corresponding to a given key, or NULL if the key
+ * is not found in the table. If the table contains duplicate keys,
+ * the value that was latest inserted will be returned.
+ */
+void *table_lookup(const table *t, const void *key)
+{
+	// Scan from the front of the list. Return first match and move
+	// it forward according to the policy.
+	for (int pos = t->size - 1; pos >= 0; pos--) {
+		if (t->key_cmp_func(t->entries[pos].key, key) == 0) {
+			void *value = t->entries[pos].value;
+
+			reorganize(t, pos);
+			return value;
+		}
+	}
+	// No match found. Return NULL.
+	return NULL;
+}
+
+/**
+ * table_lookup_many() - Look up a batch of keys in a table.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @values: Array of n pointers, set to the value for each key or NULL.
+ * @n: Number of keys.
+ *
+ * Every lookup reorganizes the list, so the keys are looked up one at
+ * a time in array order.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_many(const table *t, void *const *keys, void **values, int n)
+{
+	for (int i = 0; i < n; i++) {
+		values[i] = table_lookup(t, keys[i]);
+	}
+}
+
+/**
+ * table_choose_key() - Return an arbitrary key.
+ * @t: Table to inspect.
+ *
+ * Return an arbitrary key stored in the table. Can be used together
+ * with table_remove() to deconstruct the table. Undefined for an
+ * empty table.
+ *
+ * Returns: An arbitrary key stored in the table.
+ */
+void *table_choose_key(const table *t)
+{
+	// Return the key first in the list, it is found immediately by
+	// table_remove().
+	return t->entries[t->size - 1].key;
+}
+
+/**
+ * table_remove() - Remove a key/value pair in the table.
+ * @table: Table to manipulate.
+ * @key: Key for which to remove pair.
+ *
+ * Any matching duplicates will be removed. Will call any free
+ * functions set for keys/values. Does nothing if key is not found in
+ * the table.
+ *
+ * Returns: Nothing.
+ */
+void table_remove(table *t, const void *key)
+{
+	// Will be set if we need to delay a free.
+	void *deferred_ptr = NULL;
+	// Number of entries kept so far.
+	int kept = 0;
+
+	// Compact the array in one pass, keeping the order of all
+	// entries that do not match.
+	for (int pos = 0; pos < t->size; pos++) {
+		struct table_entry *entry = &t->entries[pos];
+
+		if (t->key_cmp_func(entry->key, key) == 0) {
+			if (t->key_free_func != NULL) {
+				if (entry->key == key) {
+					// The given key points to the same
+					// memory as entry->key. Defer the free
+					// since key is used in later compares.
+					deferred_ptr = entry->key;
+				} else {
+					t->key_free_func(entry->key);
+				}
+			}
+			if (t->value_free_func != NULL) {
+				t->value_free_func(entry->value);
+			}
+		} else {
+			t->entries[kept++] = *entry;
+		}
+	}
+	t->size = kept;
+
+	// Halve the array when less than a quarter of it is used.
+	if (t->capacity / 2 >= t->min_capacity && t->size < t->capacity / 4) {
+		set_capacity(t, t->capacity / 2);
+	}
+
+	if (deferred_ptr != NULL) {
+		// Take care of the delayed free.
+		t->key_free_func(deferred_ptr);
+	}
+}
+
+/**
+ * table_reserve() - Prepare a table to hold a number of entries.
+ * @t: Table to manipulate.
+ * @n: Expected number of entries.
+ *
+ * Grows the entry array to hold at least n entries, and keeps it at
+ * least that large when entries are removed.
+ *
+ * Returns: Nothing.
+ */
+void table_reserve(table *t, int n)
+{
+	t->min_capacity = INITIAL_CAPACITY;
+	while (t->min_capacity < n) {
+		t->min_capacity *= 2;
+	}
+
+	if (t->capacity < t->min_capacity) {
+		set_capacity(t, t->min_capacity);
+	}
+}
+
+/*
+ * table_kill() - Destroy a table.
+ * @table: Table to destroy.
+ *
+ * Return all dynamic memory used by the table and its elements. If a
+ * free_func was registered for keys and/or values at table creation,
+ * it is called each element to free any user-allocated memory
+ * occupied by the element values.
+ *
+ * Returns: Nothing.
+ */
+void table_kill(table *t)
+{
+	for (int pos = 0; pos < t->size; pos++) {
+		// Free key and/or value if given the authority to do so.
+		if (t->key_free_func != NULL) {
+			t->key_free_func(t->entries[pos].key);
+		}
+		if (t->value_free_func != NULL) {
+			t->value_free_func(t->entries[pos].value);
+		}
+	}
+
+	free(t->entries);
+	free(t);
+}
+
+/**
+ * table_print() - Print the given table.
+ * @t: Table to print.
+ * @print_func: Function called for each key/value pair in the table.
+ *
+ * Iterates over the key/value pairs in the table and prints them, in
+ * list order starting with the front.
+ * Will print all stored elements, including duplicates.
+ *
+ * Returns: Nothing.
+ */
+void table_print(const table *t, inspect_callback_pair print_func)
+{
+	for (int pos = t->size - 1; pos >= 0; pos--) {
+		print_func(t->entries[pos].key, t->entries[pos].value);
+	}
+}
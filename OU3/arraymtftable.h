@@ -0,0 +1,57 @@
+#ifndef __ARRAYMTFTABLE_H
+#define __ARRAYMTFTABLE_H
+
+#include "table.h"
+
+/*
+ * Extra constructor for the self-organizing table in arraymtftable.c.
+ * The policy decides how an entry found by table_lookup() is moved
+ * towards the front of the list. table_empty() gives a table with the
+ * POLICY_MOVE_TO_FRONT policy. All other operations are the ones
+ * declared in table.h.
+ *
+ * Authors: Adam Pettersson
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first public version.
+ */
+
+/**
+ * enum table_policy - How a found entry is moved in the list.
+ * @POLICY_MOVE_TO_FRONT: Move the entry first in the list. Best when
+ *			  recently used keys are likely to be used again.
+ * @POLICY_TRANSPOSE: Swap the entry with the one in front of it. Slow
+ *		      to adapt but stable for wide, mildly skewed access.
+ * @POLICY_COUNT: Count lookups per entry and keep the list ordered by
+ *		  count, highest first. A found entry is moved ahead of all
+ *		  entries with the same or a lower count. A new entry
+ *		  starts behind all entries that have been found, unless
+ *		  it hides a duplicate, whose count it takes over.
+ * @POLICY_MOVE_AHEAD: Move the entry k steps towards the front.
+ */
+typedef enum table_policy {
+	POLICY_MOVE_TO_FRONT,
+	POLICY_TRANSPOSE,
+	POLICY_COUNT,
+	POLICY_MOVE_AHEAD,
+} table_policy;
+
+/**
+ * table_empty_policy() - Create an empty self-organizing table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @policy: How entries are moved when found by table_lookup().
+ * @k: Number of steps for POLICY_MOVE_AHEAD. Ignored for the other
+ *     policies.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_policy(compare_function *key_cmp_func,
+			  table_policy policy, int k,
+			  free_function key_free_func,
+			  free_function value_free_func);
+
+#endif
@@ -1,35 +1,108 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include "table.h"
-#include "array_1d.h"
+#include "keysort.h"
 
-// The maximum allowed size of the field is set to 8000 characthers
-#define MAX_TABLE_SIZE 80000
+// Number of entries a new table has room for. The arrays are doubled
+// when they are full and halved when less than a quarter is used.
+#define INITIAL_CAPACITY 16
 
-/*
-//Each table entry has a value and key and because is a
-//void pointer it can be any type of data.
-*/
-struct table_entry
-{
-    void *key;
-    void *value;
-};
+// Batches up to this size are handled one key at a time, larger
+// batches are sorted and matched against the table in one pass.
+#define SMALL_BATCH 8
+
+// find_position() prefetches the key this many positions ahead of the
+// one being compared, so the key data is in cache when it is reached.
+#define KEY_PREFETCH_DISTANCE 8
 
 /*
-//entrites is a field of table entry structs. The field
-//have a maximum size of MAX_TABLE_SIZE.
+//The keys and values are stored inline in two parallel arrays, the
+//key and value of entry i are keys[i] and values[i]. Because the keys
+//are void pointers they can be any type of data.
 //
-//size keeps track of the number of entries in the table
+//Entries are kept packed in positions 0..size-1, so a scan walks
+//contiguous memory and never has to follow a pointer per entry.
+//
+//size keeps track of the number of entries in the table, capacity
+//of the number of entries the arrays have room for. The arrays are
+//never shrunk below min_capacity, set by table_reserve().
 */
 struct table
 {
-    array_1d *entries;
+    void **keys;
+    void **values;
+    int size;
+    int capacity;
+    int min_capacity;
     compare_function *key_cmp_func;
     free_function key_free_func;
     free_function value_free_func;
 };
 
+/*
+//find_position() - Return the position of key in the table, or -1 if
+//the key is not in the table.
+*/
+static int find_position(const table *t, const void *key)
+{
+    // Only the key array is touched until a match is found. The key
+    // array itself is read in order, but the keys it points to may be
+    // anywhere, so they are prefetched ahead of the compare.
+    for (int position = 0; position < t->size; position++)
+    {
+        if (position + KEY_PREFETCH_DISTANCE < t->size)
+        {
+            __builtin_prefetch(t->keys[position + KEY_PREFETCH_DISTANCE]);
+        }
+        if (t->key_cmp_func(t->keys[position], key) == 0)
+        {
+            return position;
+        }
+    }
+
+    return -1;
+}
+
+/*
+//set_capacity() - Reallocate the key and value arrays to have room
+//for capacity entries.
+*/
+static void set_capacity(table *t, int capacity)
+{
+    t->keys = realloc(t->keys, capacity * sizeof(void *));
+    t->values = realloc(t->values, capacity * sizeof(void *));
+    t->capacity = capacity;
+}
+
+/*
+//free_replaced() - Call any free functions on a key/value pair that
+//is replaced by key/value, but never on the memory being inserted.
+*/
+static void free_replaced(const table *t, void *old_key, void *old_value, void *key, void *value)
+{
+    if (t->key_free_func != NULL && old_key != key)
+    {
+        t->key_free_func(old_key);
+    }
+    if (t->value_free_func != NULL && old_value != value)
+    {
+        t->value_free_func(old_value);
+    }
+}
+
+/*
+//sorted_table_order() - Return the positions 0..size-1 of the table
+//sorted by key. The caller must free the array.
+*/
+static int *sorted_table_order(const table *t)
+{
+    int *order = malloc((t->size > 0 ? t->size : 1) * sizeof(int));
+
+    keysort(t->keys, order, t->size, t->key_cmp_func);
+
+    return order;
+}
+
 /**
  * table_empty() - Create an empty table.
  * @key_cmp_func: A pointer to a function to be used to compare keys.
@@ -50,8 +123,12 @@ table *table_empty(compare_function key_cmp_func, free_function key_free_func, f
     t->key_free_func = key_free_func;
     t->value_free_func = value_free_func;
 
-    // Create an empty array_1d for the table entries.
-    t->entries = array_1d_create(0, MAX_TABLE_SIZE, NULL);
+    // Create small key and value arrays, they grow when needed.
+    t->keys = malloc(INITIAL_CAPACITY * sizeof(void *));
+    t->values = malloc(INITIAL_CAPACITY * sizeof(void *));
+    t->size = 0;
+    t->capacity = INITIAL_CAPACITY;
+    t->min_capacity = INITIAL_CAPACITY;
 
     return t;
 }
@@ -64,18 +141,18 @@ table *table_empty(compare_function key_cmp_func, free_function key_free_func, f
  */
 bool table_is_empty(const table *t)
 {
-    // Iterate through the array.
-    for (int position = array_1d_low(t->entries); position <= array_1d_high(t->entries); position++)
-    {
-        // If an element with a value is found, the table is not empty.
-        if (array_1d_has_value(t->entries, position))
-        {
-            return false;
-        }
-    }
+    return t->size == 0;
+}
 
-    // If the loop completes without finding any elements with values, the table is empty.
-    return true;
+/**
+ * table_size() - Return the number of entries in a table.
+ * @t: Table to inspect.
+ *
+ * Returns: The number of key/value pairs in the table.
+ */
+int table_size(const table *t)
+{
+    return t->size;
 }
 
 /**
@@ -84,48 +161,147 @@ bool table_is_empty(const table *t)
  * @key: A pointer to the key value.
  * @value: A pointer to the value value.
  *
- * Insert the key/value pair into the table. No test is performed to
- * check if key is a duplicate. table_lookup() will return the latest
- * added value for a duplicate key. table_remove() will remove all
- * duplicates for a given key.
+ * Insert the key/value pair into the table. If the key is already in
+ * the table the old key/value pair is replaced, and any free functions
+ * set for keys/values are called on the old pair.
  *
  * Returns: Nothing.
  */
 void table_insert(table *t, void *key, void *value)
 {
-    struct table_entry *entry = malloc(sizeof(struct table_entry));
+    int position = find_position(t, key);
+
+    if (position != -1)
+    {
+        // Replace the duplicate.
+        free_replaced(t, t->keys[position], t->values[position], key, value);
+        t->keys[position] = key;
+        t->values[position] = value;
+        return;
+    }
 
-    entry->key = key;
-    entry->value = value;
+    // New key, put it after the last entry. Double the arrays first
+    // if they are full.
+    if (t->size == t->capacity)
+    {
+        set_capacity(t, t->capacity * 2);
+    }
 
-    int position = 0;
+    t->keys[t->size] = key;
+    t->values[t->size] = value;
+    t->size++;
+}
 
-    while (array_1d_has_value(t->entries, position))
+/**
+ * table_insert_many() - Add a batch of key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n pointers to key values.
+ * @values: Array of n pointers to value values.
+ * @n: Number of pairs.
+ *
+ * Same result as calling table_insert() for each pair in order. Large
+ * batches are sorted together with the keys already in the table and
+ * matched in one merge pass, so loading n keys costs O(n log n)
+ * instead of one scan of the table per key.
+ *
+ * Returns: Nothing.
+ */
+void table_insert_many(table *t, void *const *keys, void *const *values, int n)
+{
+    if (n <= SMALL_BATCH)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            table_insert(t, keys[i], values[i]);
+        }
+        return;
+    }
+
+    int *batch_order = malloc(n * sizeof(int));
+    keysort(keys, batch_order, n, t->key_cmp_func);
+    int *table_order = sorted_table_order(t);
+
+    // winner[i] is set for the first occurrence i of each new key to
+    // the position in the batch of its latest occurrence.
+    int *winner = malloc(n * sizeof(int));
+    for (int i = 0; i < n; i++)
     {
-        struct table_entry *entry_temp = array_1d_inspect_value(t->entries, position);
+        winner[i] = -1;
+    }
 
-        if (t->key_cmp_func(entry_temp->key, key) == 0)
+    int table_pos = 0;
+    int group = 0;
+    while (group < n)
+    {
+        // The batch positions group..group_end-1 hold equal keys, in
+        // batch order since the sort is stable.
+        int group_end = group + 1;
+        while (group_end < n && t->key_cmp_func(keys[batch_order[group]], keys[batch_order[group_end]]) == 0)
         {
-            array_1d_set_value(t->entries, entry, position);
+            group_end++;
+        }
 
-            if (t->key_free_func != NULL)
+        // Find the key among the keys already in the table.
+        const void *key = keys[batch_order[group]];
+        while (table_pos < t->size && t->key_cmp_func(t->keys[table_order[table_pos]], key) < 0)
+        {
+            table_pos++;
+        }
+        int position = -1;
+        if (table_pos < t->size && t->key_cmp_func(t->keys[table_order[table_pos]], key) == 0)
+        {
+            position = table_order[table_pos];
+        }
+
+        // Each occurrence replaces the previous one, as if inserted
+        // one at a time.
+        for (int g = group; g < group_end; g++)
+        {
+            int i = batch_order[g];
+
+            if (g > group)
             {
-                t->key_free_func(entry_temp->key);
+                int prev = batch_order[g - 1];
+                free_replaced(t, keys[prev], values[prev], keys[i], values[i]);
             }
-            if (t->value_free_func != NULL)
+            else if (position != -1)
             {
-                t->value_free_func(entry_temp->value);
+                free_replaced(t, t->keys[position], t->values[position], keys[i], values[i]);
             }
+        }
+
+        int latest = batch_order[group_end - 1];
+        if (position != -1)
+        {
+            t->keys[position] = keys[latest];
+            t->values[position] = values[latest];
+        }
+        else
+        {
+            winner[batch_order[group]] = latest;
+        }
 
-            free(entry_temp);
-            return;
+        group = group_end;
+    }
+
+    // Append the new keys in the order they first appear in the batch.
+    for (int i = 0; i < n; i++)
+    {
+        if (winner[i] != -1)
+        {
+            if (t->size == t->capacity)
+            {
+                set_capacity(t, t->capacity * 2);
+            }
+            t->keys[t->size] = keys[winner[i]];
+            t->values[t->size] = values[winner[i]];
+            t->size++;
         }
-        position++;
     }
 
-    entry->key = key;
-    entry->value = value;
-    array_1d_set_value(t->entries, entry, position);
+    free(winner);
+    free(table_order);
+    free(batch_order);
 }
 
 /**
@@ -134,27 +310,69 @@ void table_insert(table *t, void *key, void *value)
  * @key: Key to look up.
  *
  * Returns: The value corresponding to a given key, or NULL if the key
- * is not found in the table. If the table contains duplicate keys,
- * the value that was latest inserted will be returned.
+ * is not found in the table.
  */
 void *table_lookup(const table *t, const void *key)
 {
-    int position = 0;
-    void *latest_value = NULL;
+    int position = find_position(t, key);
+
+    if (position == -1)
+    {
+        return NULL;
+    }
+
+    return t->values[position];
+}
+
+/**
+ * table_lookup_many() - Look up a batch of keys in a table.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @values: Array of n pointers, set to the value for each key or NULL.
+ * @n: Number of keys.
+ *
+ * Large batches are sorted together with the keys in the table and
+ * answered in one merge pass instead of one scan of the table per key.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_many(const table *t, void *const *keys, void **values, int n)
+{
+    if (n <= SMALL_BATCH || t->size <= SMALL_BATCH)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            values[i] = table_lookup(t, keys[i]);
+        }
+        return;
+    }
 
-    // Iterate over the array to find the latest inserted value for the key.
-    while (array_1d_has_value(t->entries, position))
+    int *batch_order = malloc(n * sizeof(int));
+    keysort(keys, batch_order, n, t->key_cmp_func);
+    int *table_order = sorted_table_order(t);
+
+    int table_pos = 0;
+    for (int b = 0; b < n; b++)
     {
-        struct table_entry *entry = array_1d_inspect_value(t->entries, position);
+        int i = batch_order[b];
+
+        while (table_pos < t->size && t->key_cmp_func(t->keys[table_order[table_pos]], keys[i]) < 0)
+        {
+            table_pos++;
+        }
 
-        if (t->key_cmp_func(entry->key, key) == 0)
+        if (table_pos < t->size && t->key_cmp_func(t->keys[table_order[table_pos]], keys[i]) == 0)
+        {
+            values[i] = t->values[table_order[table_pos]];
+        }
+        else
         {
-            latest_value = entry->value;
+            values[i] = NULL;
         }
-        position++;
     }
 
-    return latest_value;
+    free(table_order);
+    free(batch_order);
 }
 
 /**
@@ -170,85 +388,80 @@ void *table_lookup(const table *t, const void *key)
 
 void *table_choose_key(const table *t)
 {
-    // Start at the beginning of the array.
-    int position = array_1d_low(t->entries);
-
-    // Iterate over the array to find the first non-null entry.
-    while (position <= array_1d_high(t->entries))
+    // If the table is empty, return NULL.
+    if (t->size == 0)
     {
-        if (array_1d_has_value(t->entries, position))
-        {
-            // Inspect the table entry.
-            struct table_entry *entry = array_1d_inspect_value(t->entries, position);
-
-            // Return the key of the first non-null entry.
-            return entry->key;
-        }
-        // Move on to the next position in the array.
-        position++;
+        return NULL;
     }
 
-    // If no non-null entries are found, return NULL.
-    return NULL;
+    // Return the key of the first entry.
+    return t->keys[0];
 }
 
 /*
 table_remove() - Remove a key/value pair in the table.
 @table: Table to manipulate.
 @key: Key for which to remove pair.
-Any matching duplicates will be removed. Will call any free
-functions set for keys/values. Does nothing if key is not found in
-the table.
+Will call any free functions set for keys/values. Does nothing if key
+is not found in the table.
 Returns: Nothing.
 */
 void table_remove(table *t, const void *key)
 {
-    void *deferred_ptr = NULL;
+    int position = find_position(t, key);
 
-    int pos = 0;
-    int removed_pos = -1;
+    if (position == -1)
+    {
+        return;
+    }
+
+    void *removed_key = t->keys[position];
+    void *removed_value = t->values[position];
+
+    // Fill the hole with the last entry to keep the arrays packed.
+    t->size--;
+    t->keys[position] = t->keys[t->size];
+    t->values[position] = t->values[t->size];
 
-    while (array_1d_has_value(t->entries, pos))
+    // Halve the arrays when less than a quarter of them is used.
+    if (t->capacity / 2 >= t->min_capacity && t->size < t->capacity / 4)
     {
-        struct table_entry *entry = array_1d_inspect_value(t->entries, pos);
+        set_capacity(t, t->capacity / 2);
+    }
 
-        if (t->key_cmp_func(entry->key, key) == 0)
-        {
-            if (t->key_free_func != NULL)
-            {
-                if (entry->key == key)
-                {
-                    deferred_ptr = entry->key;
-                }
-                else
-                {
-                    t->key_free_func(entry->key);
-                }
-            }
-            if (t->value_free_func != NULL)
-            {
-                t->value_free_func(entry->value);
-            }
+    // The key is freed last since it may point to the same memory as
+    // the key given by the caller.
+    if (t->value_free_func != NULL)
+    {
+        t->value_free_func(removed_value);
+    }
+    if (t->key_free_func != NULL)
+    {
+        t->key_free_func(removed_key);
+    }
+}
 
-            removed_pos = pos;
-            array_1d_set_value(t->entries, NULL, pos);
-            free(entry);
-        }
-        else
-        {
-            if (removed_pos != -1)
-            {
-                array_1d_set_value(t->entries, entry, removed_pos);
-                array_1d_set_value(t->entries, NULL, pos);
-                removed_pos++;
-            }
-        }
-        pos++;
+/**
+ * table_reserve() - Prepare a table to hold a number of entries.
+ * @t: Table to manipulate.
+ * @n: Expected number of entries.
+ *
+ * Grows the key and value arrays to hold at least n entries, and
+ * keeps them at least that large when entries are removed.
+ *
+ * Returns: Nothing.
+ */
+void table_reserve(table *t, int n)
+{
+    t->min_capacity = INITIAL_CAPACITY;
+    while (t->min_capacity < n)
+    {
+        t->min_capacity *= 2;
     }
 
-    if (deferred_ptr != NULL)
+    if (t->capacity < t->min_capacity)
     {
-        t->key_free_func(deferred_ptr);
+        set_capacity(t, t->min_capacity);
     }
 }
 
@@ -265,28 +478,20 @@ void table_remove(table *t, const void *key)
  */
 void table_kill(table *t)
 {
-
-    int position = array_1d_low(t->entries);
-
-    while (position <= array_1d_high(t->entries))
+    for (int position = 0; position < t->size; position++)
     {
-        if (array_1d_has_value(t->entries, position))
+        if (t->key_free_func != NULL)
         {
-            struct table_entry *entry = array_1d_inspect_value(t->entries, position);
-            if (t->key_free_func != NULL)
-            {
-                t->key_free_func(entry->key);
-            }
-            if (t->value_free_func != NULL)
-            {
-                t->value_free_func(entry->value);
-            }
-            free(entry);
+            t->key_free_func(t->keys[position]);
+        }
+        if (t->value_free_func != NULL)
+        {
+            t->value_free_func(t->values[position]);
         }
-        position++;
     }
 
-    array_1d_kill(t->entries);
+    free(t->keys);
+    free(t->values);
     free(t);
 }
 
@@ -302,15 +507,8 @@ void table_kill(table *t)
  */
 void table_print(const table *t, inspect_callback_pair print_func)
 {
-    int position = array_1d_low(t->entries);
-
-    while (position <= array_1d_high(t->entries))
+    for (int position = 0; position < t->size; position++)
     {
-        if (array_1d_has_value(t->entries, position))
-        {
-            struct table_entry *y = array_1d_inspect_value(t->entries, position);
-            print_func(y->key, y->value);
-        }
-        position++;
+        print_func(t->keys[position], t->values[position]);
     }
-}
\ No newline at end of file
+}
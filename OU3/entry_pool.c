@@ -0,0 +1,147 @@
+/*
+ * Implementation of the entry pool in entry_pool.h. Every slab starts
+ * with a header that links it to the previously allocated slab,
+ * followed by the entries. Free entries are kept in a singly linked
+ * list threaded through the entries themselves.
+ *
+ * Authors: Adam Pettersson
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first public version.
+ */
+
+#include <stdlib.h>
+#include "entry_pool.h"
+
+// The first slab holds this many entries. Each new slab is twice as
+// large as the previous one, up to MAX_SLAB_ENTRIES.
+#define FIRST_SLAB_ENTRIES 32
+#define MAX_SLAB_ENTRIES 4096
+
+/*
+// Header of a slab. The header is a union with max_align_t-like
+// members so that the entries after it are suitably aligned.
+*/
+union slab
+{
+	union slab *prev;
+	long double align_ld;
+	void *align_ptr;
+	long long align_ll;
+};
+
+/*
+// A free entry stores the link to the next free entry.
+*/
+struct free_entry
+{
+	struct free_entry *next;
+};
+
+/*
+// slabs is the latest slab. next_unused..slab_end is the part of the
+// latest slab that has never been handed out. free_list holds entries
+// returned by entry_pool_free().
+*/
+struct entry_pool
+{
+	size_t entry_size;
+	union slab *slabs;
+	char *next_unused;
+	char *slab_end;
+	int slab_entries;
+	struct free_entry *free_list;
+};
+
+/**
+ * entry_pool_empty() - Create an empty pool.
+ * @entry_size: Size in bytes of each entry.
+ *
+ * Returns: Pointer to a new pool.
+ */
+entry_pool *entry_pool_empty(size_t entry_size)
+{
+	entry_pool *p = calloc(1, sizeof(entry_pool));
+
+	// Round the size up so that every entry stays aligned and can
+	// hold the free list link.
+	size_t align = sizeof(union slab);
+	if (entry_size < sizeof(struct free_entry))
+	{
+		entry_size = sizeof(struct free_entry);
+	}
+	p->entry_size = (entry_size + align - 1) / align * align;
+	p->slab_entries = FIRST_SLAB_ENTRIES;
+
+	return p;
+}
+
+/**
+ * entry_pool_alloc() - Get an entry from the pool.
+ * @p: Pool to allocate from.
+ *
+ * Returns: Pointer to an uninitialized entry.
+ */
+void *entry_pool_alloc(entry_pool *p)
+{
+	// Reuse a returned entry if there is one.
+	if (p->free_list != NULL)
+	{
+		struct free_entry *entry = p->free_list;
+		p->free_list = entry->next;
+		return entry;
+	}
+
+	// Otherwise cut one from the latest slab, allocating a new slab
+	// when it is used up.
+	if (p->next_unused == p->slab_end)
+	{
+		union slab *slab = malloc(sizeof(union slab) + p->slab_entries * p->entry_size);
+		slab->prev = p->slabs;
+		p->slabs = slab;
+		p->next_unused = (char *)(slab + 1);
+		p->slab_end = p->next_unused + p->slab_entries * p->entry_size;
+		if (p->slab_entries < MAX_SLAB_ENTRIES)
+		{
+			p->slab_entries *= 2;
+		}
+	}
+
+	void *entry = p->next_unused;
+	p->next_unused += p->entry_size;
+	return entry;
+}
+
+/**
+ * entry_pool_free() - Return an entry to the pool.
+ * @p: Pool the entry was allocated from.
+ * @entry: Entry to return.
+ *
+ * Returns: Nothing.
+ */
+void entry_pool_free(entry_pool *p, void *entry)
+{
+	struct free_entry *free_entry = entry;
+	free_entry->next = p->free_list;
+	p->free_list = free_entry;
+}
+
+/**
+ * entry_pool_kill() - Destroy a pool and all entries allocated from it.
+ * @p: Pool to destroy.
+ *
+ * Returns: Nothing.
+ */
+void entry_pool_kill(entry_pool *p)
+{
+	union slab *slab = p->slabs;
+
+	while (slab != NULL)
+	{
+		union slab *prev = slab->prev;
+		free(slab);
+		slab = prev;
+	}
+
+	free(p);
+}
@@ -0,0 +1,59 @@
+#ifndef __ENTRY_POOL_H
+#define __ENTRY_POOL_H
+
+#include <stddef.h>
+
+/*
+ * A pool of fixed-size entries for the table implementations. Entries
+ * are cut from large slabs and recycled through a free list, so the
+ * number of calls to malloc()/free() is proportional to the number of
+ * slabs rather than the number of entries. All entries are released
+ * at once by entry_pool_kill().
+ *
+ * Authors: Adam Pettersson
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first public version.
+ */
+
+// Anonymous declaration of entry_pool.
+typedef struct entry_pool entry_pool;
+
+/**
+ * entry_pool_empty() - Create an empty pool.
+ * @entry_size: Size in bytes of each entry.
+ *
+ * Returns: Pointer to a new pool.
+ */
+entry_pool *entry_pool_empty(size_t entry_size);
+
+/**
+ * entry_pool_alloc() - Get an entry from the pool.
+ * @p: Pool to allocate from.
+ *
+ * Returns: Pointer to an uninitialized entry.
+ */
+void *entry_pool_alloc(entry_pool *p);
+
+/**
+ * entry_pool_free() - Return an entry to the pool.
+ * @p: Pool the entry was allocated from.
+ * @entry: Entry to return.
+ *
+ * The entry is reused by a later entry_pool_alloc().
+ *
+ * Returns: Nothing.
+ */
+void entry_pool_free(entry_pool *p, void *entry);
+
+/**
+ * entry_pool_kill() - Destroy a pool and all entries allocated from it.
+ * @p: Pool to destroy.
+ *
+ * Runs in time proportional to the number of slabs.
+ *
+ * Returns: Nothing.
+ */
+void entry_pool_kill(entry_pool *p);
+
+#endif
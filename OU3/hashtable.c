@@ -0,0 +1,595 @@
+/*
+ * Implementation of the table interface as a hash table with open
+ * addressing. Collisions are resolved with linear probing and entries
+ * are removed with backward shift deletion, so no tombstones are ever
+ * left in the slot array. The slot array is doubled when it becomes
+ * too full and halved when it becomes too sparse, which keeps
+ * table_insert/table_lookup/table_remove at O(1) expected time.
+ *
+ * The key_hash_func given to table_empty_hash() must give the same
+ * value for keys that key_cmp_func considers equal.
+ *
+ * Authors: Adam Pettersson
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first public version.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include "table.h"
+#include "hashtable.h"
+
+// Number of slots in a new table. Must be a power of two.
+#define INITIAL_CAPACITY 16
+
+// The table grows when more than MAX_LOAD_NUM/MAX_LOAD_DEN of the
+// slots are used and shrinks when less than 1/MIN_LOAD_DEN are used.
+#define MAX_LOAD_NUM 3
+#define MAX_LOAD_DEN 4
+#define MIN_LOAD_DEN 8
+
+// table_lookup_many() hashes this many keys and prefetches their home
+// slots before probing any of them.
+#define LOOKUP_CHUNK 16
+
+/*
+// Each slot keeps the hash value of its key so that resizing never
+// has to call the hash function again and most non-matching keys can
+// be skipped without calling key_cmp_func.
+*/
+struct slot
+{
+	void *key;
+	void *value;
+	unsigned long hash;
+	bool used;
+};
+
+/*
+// slots is an array of capacity slots, capacity is always a power of
+// two and mask is capacity - 1. The table never shrinks below
+// min_capacity, set by table_reserve().
+//
+// size keeps track of the number of entries in the table
+//
+// choose_start is where table_choose_key() starts looking for a used
+// slot. table_remove() sets it to the slot it emptied, so draining the
+// table with table_choose_key() + table_remove() does not rescan the
+// slots that were emptied before.
+*/
+struct table
+{
+	struct slot *slots;
+	int capacity;
+	int mask;
+	int min_capacity;
+	int size;
+	int choose_start;
+	compare_function *key_cmp_func;
+	hash_function *key_hash_func;
+	free_function key_free_func;
+	free_function value_free_func;
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * hash_key() - Compute the hash value of a key.
+ * @t: Table the key belongs to.
+ * @key: Key to hash.
+ *
+ * Tables created without a hash function put every key in the same
+ * probe chain, which is correct but makes all operations linear.
+ *
+ * Returns: The hash value of the key.
+ */
+static unsigned long hash_key(const table *t, const void *key)
+{
+	if (t->key_hash_func == NULL)
+	{
+		return 0;
+	}
+	return t->key_hash_func(key);
+}
+
+/**
+ * home_slot() - Compute the first slot to probe for a hash value.
+ * @t: Table to inspect.
+ * @hash: Hash value of the key.
+ *
+ * The hash value is multiplied by 2^64/phi (Fibonacci hashing) so that
+ * weak hash functions, e.g. the identity for integers, still spread
+ * out over the whole table.
+ *
+ * Returns: Index of the home slot.
+ */
+static int home_slot(const table *t, unsigned long hash)
+{
+	unsigned long long mixed = (unsigned long long)hash * 11400714819323198485ULL;
+
+	return (int)((mixed >> 32) & (unsigned long long)t->mask);
+}
+
+/**
+ * find_slot() - Find the slot holding a given key.
+ * @t: Table to inspect.
+ * @key: Key to look for.
+ * @hash: Hash value of the key.
+ *
+ * Returns: Index of the slot with the key, or -1 if not found.
+ */
+static int find_slot(const table *t, const void *key, unsigned long hash)
+{
+	int i = home_slot(t, hash);
+
+	// The load factor is kept below one so there is always an
+	// unused slot that ends the probe sequence.
+	while (t->slots[i].used)
+	{
+		if (t->slots[i].hash == hash && t->key_cmp_func(t->slots[i].key, key) == 0)
+		{
+			return i;
+		}
+		i = (i + 1) & t->mask;
+	}
+
+	return -1;
+}
+
+/**
+ * place_entry() - Put an entry known not to be in the table in a slot.
+ * @t: Table to manipulate.
+ * @key: Key of the entry.
+ * @value: Value of the entry.
+ * @hash: Hash value of the key.
+ *
+ * Returns: Nothing.
+ */
+static void place_entry(table *t, void *key, void *value, unsigned long hash)
+{
+	int i = home_slot(t, hash);
+
+	while (t->slots[i].used)
+	{
+		i = (i + 1) & t->mask;
+	}
+
+	t->slots[i].key = key;
+	t->slots[i].value = value;
+	t->slots[i].hash = hash;
+	t->slots[i].used = true;
+}
+
+/**
+ * resize() - Move all entries to a new slot array.
+ * @t: Table to manipulate.
+ * @capacity: New number of slots. Must be a power of two.
+ *
+ * Returns: Nothing.
+ */
+static void resize(table *t, int capacity)
+{
+	struct slot *old_slots = t->slots;
+	int old_capacity = t->capacity;
+
+	t->slots = calloc(capacity, sizeof(struct slot));
+	t->capacity = capacity;
+	t->mask = capacity - 1;
+	t->choose_start = 0;
+
+	// The stored hash values are reused, no key is hashed again.
+	for (int i = 0; i < old_capacity; i++)
+	{
+		if (old_slots[i].used)
+		{
+			place_entry(t, old_slots[i].key, old_slots[i].value, old_slots[i].hash);
+		}
+	}
+
+	free(old_slots);
+}
+
+/**
+ * remove_slot() - Empty a slot using backward shift deletion.
+ * @t: Table to manipulate.
+ * @i: Index of the slot to empty.
+ *
+ * Entries later in the same probe run are moved back into the hole
+ * whenever their home slot allows it, so every remaining entry can
+ * still be reached from its home slot without passing an unused slot.
+ *
+ * Returns: Nothing.
+ */
+static void remove_slot(table *t, int i)
+{
+	int j = i;
+
+	while (true)
+	{
+		j = (j + 1) & t->mask;
+
+		if (!t->slots[j].used)
+		{
+			break;
+		}
+
+		int home = home_slot(t, t->slots[j].hash);
+
+		// The entry in j may move to i unless its home slot lies
+		// cyclically in the interval (i, j].
+		bool home_between = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+
+		if (!home_between)
+		{
+			t->slots[i] = t->slots[j];
+			i = j;
+		}
+	}
+
+	t->slots[i].used = false;
+	t->slots[i].key = NULL;
+	t->slots[i].value = NULL;
+}
+
+// ===========PUBLIC FUNCTION IMPLEMENTATIONS============
+
+/**
+ * table_empty_hash() - Create an empty hash table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function to be used to hash keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_hash(compare_function *key_cmp_func,
+			hash_function *key_hash_func,
+			free_function key_free_func,
+			free_function value_free_func)
+{
+	// Allocate the table header.
+	table *t = malloc(sizeof(table));
+
+	// Store the key compare/hash functions and key/value free functions.
+	t->key_cmp_func = key_cmp_func;
+	t->key_hash_func = key_hash_func;
+	t->key_free_func = key_free_func;
+	t->value_free_func = value_free_func;
+
+	// Create the slot array, all slots start out unused.
+	t->slots = calloc(INITIAL_CAPACITY, sizeof(struct slot));
+	t->capacity = INITIAL_CAPACITY;
+	t->mask = INITIAL_CAPACITY - 1;
+	t->min_capacity = INITIAL_CAPACITY;
+	t->size = 0;
+	t->choose_start = 0;
+
+	return t;
+}
+
+/**
+ * table_empty() - Create an empty table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Without a hash function all keys end up in one probe chain. Use
+ * table_empty_hash() to get O(1) expected operations.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty(compare_function *key_cmp_func,
+		   free_function key_free_func,
+		   free_function value_free_func)
+{
+	return table_empty_hash(key_cmp_func, NULL, key_free_func, value_free_func);
+}
+
+/**
+ * table_is_empty() - Check if a table is empty.
+ * @table: Table to check.
+ *
+ * Returns: True if table contains no key/value pairs, false otherwise.
+ */
+bool table_is_empty(const table *t)
+{
+	return t->size == 0;
+}
+
+/**
+ * table_size() - Return the number of entries in a table.
+ * @t: Table to inspect.
+ *
+ * Returns: The number of key/value pairs in the table.
+ */
+int table_size(const table *t)
+{
+	return t->size;
+}
+
+/**
+ * table_insert() - Add a key/value pair to a table.
+ * @table: Table to manipulate.
+ * @key: A pointer to the key value.
+ * @value: A pointer to the value value.
+ *
+ * Insert the key/value pair into the table. If the key is already in
+ * the table, the old key/value pair is replaced and any free
+ * functions set for keys/values are called on the old pair.
+ *
+ * Returns: Nothing.
+ */
+void table_insert(table *t, void *key, void *value)
+{
+	unsigned long hash = hash_key(t, key);
+	int i = find_slot(t, key, hash);
+
+	if (i != -1)
+	{
+		// Replace the duplicate, but never free the memory that
+		// is being inserted.
+		struct slot *s = &t->slots[i];
+
+		if (t->key_free_func != NULL && s->key != key)
+		{
+			t->key_free_func(s->key);
+		}
+		if (t->value_free_func != NULL && s->value != value)
+		{
+			t->value_free_func(s->value);
+		}
+		s->key = key;
+		s->value = value;
+		return;
+	}
+
+	// Grow before the new entry pushes the load factor too high.
+	if ((t->size + 1) * MAX_LOAD_DEN > t->capacity * MAX_LOAD_NUM)
+	{
+		resize(t, t->capacity * 2);
+	}
+
+	place_entry(t, key, value, hash);
+	t->size++;
+}
+
+/**
+ * table_insert_many() - Add a batch of key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n pointers to key values.
+ * @values: Array of n pointers to value values.
+ * @n: Number of pairs.
+ *
+ * Same result as calling table_insert() for each pair in order. The
+ * slot array is grown once for the whole batch up front instead of
+ * doubling repeatedly while the pairs are inserted.
+ *
+ * Returns: Nothing.
+ */
+void table_insert_many(table *t, void *const *keys, void *const *values, int n)
+{
+	int capacity = t->capacity;
+	while ((long)(t->size + n) * MAX_LOAD_DEN > (long)capacity * MAX_LOAD_NUM)
+	{
+		capacity *= 2;
+	}
+	if (capacity > t->capacity)
+	{
+		resize(t, capacity);
+	}
+
+	for (int i = 0; i < n; i++)
+	{
+		table_insert(t, keys[i], values[i]);
+	}
+}
+
+/**
+ * table_lookup() - Look up a given key in a table.
+ * @table: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The value corresponding to a given key, or NULL if the key
+ * is not found in the table.
+ */
+void *table_lookup(const table *t, const void *key)
+{
+	int i = find_slot(t, key, hash_key(t, key));
+
+	if (i == -1)
+	{
+		return NULL;
+	}
+	return t->slots[i].value;
+}
+
+/**
+ * table_lookup_many() - Look up a batch of keys in a table.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @values: Array of n pointers, set to the value for each key or NULL.
+ * @n: Number of keys.
+ *
+ * The keys are handled in chunks. All keys in a chunk are hashed and
+ * their home slots prefetched before the first one is probed, so the
+ * cache misses of the chunk overlap instead of being taken one by one.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_many(const table *t, void *const *keys, void **values, int n)
+{
+	unsigned long hashes[LOOKUP_CHUNK];
+
+	for (int start = 0; start < n; start += LOOKUP_CHUNK)
+	{
+		int end = start + LOOKUP_CHUNK < n ? start + LOOKUP_CHUNK : n;
+
+		for (int i = start; i < end; i++)
+		{
+			hashes[i - start] = hash_key(t, keys[i]);
+#ifdef __GNUC__
+			__builtin_prefetch(&t->slots[home_slot(t, hashes[i - start])]);
+#endif
+		}
+
+		for (int i = start; i < end; i++)
+		{
+			int slot = find_slot(t, keys[i], hashes[i - start]);
+			values[i] = slot == -1 ? NULL : t->slots[slot].value;
+		}
+	}
+}
+
+/**
+ * table_choose_key() - Return an arbitrary key.
+ * @t: Table to inspect.
+ *
+ * Return an arbitrary key stored in the table. Can be used together
+ * with table_remove() to deconstruct the table. Undefined for an
+ * empty table.
+ *
+ * Returns: An arbitrary key stored in the table.
+ */
+void *table_choose_key(const table *t)
+{
+	// Return the key in the first used slot from choose_start,
+	// wrapping around to cover the whole table.
+	for (int n = 0; n < t->capacity; n++)
+	{
+		int i = (t->choose_start + n) & t->mask;
+
+		if (t->slots[i].used)
+		{
+			return t->slots[i].key;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * table_remove() - Remove a key/value pair in the table.
+ * @table: Table to manipulate.
+ * @key: Key for which to remove pair.
+ *
+ * Will call any free functions set for keys/values. Does nothing if
+ * key is not found in the table.
+ *
+ * Returns: Nothing.
+ */
+void table_remove(table *t, const void *key)
+{
+	int i = find_slot(t, key, hash_key(t, key));
+
+	if (i == -1)
+	{
+		return;
+	}
+
+	void *old_key = t->slots[i].key;
+	void *old_value = t->slots[i].value;
+
+	remove_slot(t, i);
+	t->size--;
+	t->choose_start = i;
+
+	// The key is freed last since it may be the same memory as the
+	// key given by the caller.
+	if (t->value_free_func != NULL)
+	{
+		t->value_free_func(old_value);
+	}
+	if (t->key_free_func != NULL)
+	{
+		t->key_free_func(old_key);
+	}
+
+	// Shrink when the table has become sparse.
+	if (t->capacity > t->min_capacity && t->size * MIN_LOAD_DEN < t->capacity)
+	{
+		resize(t, t->capacity / 2);
+	}
+}
+
+/**
+ * table_reserve() - Prepare a table to hold a number of entries.
+ * @t: Table to manipulate.
+ * @n: Expected number of entries.
+ *
+ * Grows the slot array so that n entries fit without passing the
+ * maximum load factor, and keeps it at least that large when entries
+ * are removed.
+ *
+ * Returns: Nothing.
+ */
+void table_reserve(table *t, int n)
+{
+	t->min_capacity = INITIAL_CAPACITY;
+	while ((long)n * MAX_LOAD_DEN > (long)t->min_capacity * MAX_LOAD_NUM)
+	{
+		t->min_capacity *= 2;
+	}
+
+	if (t->capacity < t->min_capacity)
+	{
+		resize(t, t->min_capacity);
+	}
+}
+
+/*
+ * table_kill() - Destroy a table.
+ * @table: Table to destroy.
+ *
+ * Return all dynamic memory used by the table and its elements. If a
+ * free_func was registered for keys and/or values at table creation,
+ * it is called each element to free any user-allocated memory
+ * occupied by the element values.
+ *
+ * Returns: Nothing.
+ */
+void table_kill(table *t)
+{
+	for (int i = 0; i < t->capacity; i++)
+	{
+		if (t->slots[i].used)
+		{
+			// Free key and/or value if given the authority to do so.
+			if (t->key_free_func != NULL)
+			{
+				t->key_free_func(t->slots[i].key);
+			}
+			if (t->value_free_func != NULL)
+			{
+				t->value_free_func(t->slots[i].value);
+			}
+		}
+	}
+
+	free(t->slots);
+	free(t);
+}
+
+/**
+ * table_print() - Print the given table.
+ * @t: Table to print.
+ * @print_func: Function called for each key/value pair in the table.
+ *
+ * Iterates over the key/value pairs in the table and prints them.
+ *
+ * Returns: Nothing.
+ */
+void table_print(const table *t, inspect_callback_pair print_func)
+{
+	for (int i = 0; i < t->capacity; i++)
+	{
+		if (t->slots[i].used)
+		{
+			print_func(t->slots[i].key, t->slots[i].value);
+		}
+	}
+}
@@ -0,0 +1,42 @@
+#ifndef __HASHTABLE_H
+#define __HASHTABLE_H
+
+#include "table.h"
+
+/*
+ * Extra constructor for the open-addressing implementation of the
+ * table interface in hashtable.c. All other operations are the ones
+ * declared in table.h.
+ *
+ * Authors: Adam Pettersson
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first public version.
+ */
+
+/**
+ * hash_function - Type of the function used to hash keys.
+ *
+ * Two keys that are equal according to the compare function of the
+ * table MUST give the same hash value. The table mixes the returned
+ * value itself, so a plain identity hash for integers is fine.
+ */
+typedef unsigned long hash_function(const void *key);
+
+/**
+ * table_empty_hash() - Create an empty hash table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_hash_func: A pointer to a function to be used to hash keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty_hash(compare_function *key_cmp_func,
+			hash_function *key_hash_func,
+			free_function key_free_func,
+			free_function value_free_func);
+
+#endif
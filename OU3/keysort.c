@@ -0,0 +1,86 @@
+/*
+ * Implementation of keysort(), a bottom-up merge sort of key
+ * positions. See keysort.h.
+ *
+ * Authors: Adam Pettersson
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first public version.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "keysort.h"
+
+/**
+ * keysort() - Sort key positions by key.
+ * @keys: Array of n keys. Not modified.
+ * @order: Array of n ints, set to the sorted positions.
+ * @n: Number of keys.
+ * @cmp: Function used to compare keys.
+ *
+ * Returns: Nothing.
+ */
+void keysort(void *const *keys, int *order, int n, compare_function *cmp)
+{
+	for (int i = 0; i < n; i++)
+	{
+		order[i] = i;
+	}
+	if (n < 2)
+	{
+		return;
+	}
+
+	int *from = order;
+	int *to = malloc(n * sizeof(int));
+
+	// Merge runs of width 1, 2, 4, ... until one run is left.
+	for (int width = 1; width < n; width *= 2)
+	{
+		for (int low = 0; low < n; low += 2 * width)
+		{
+			int mid = low + width < n ? low + width : n;
+			int high = low + 2 * width < n ? low + 2 * width : n;
+			int i = low;
+			int j = mid;
+			int out = low;
+
+			// Take from the left run on ties to keep the sort stable.
+			while (i < mid && j < high)
+			{
+				if (cmp(keys[from[j]], keys[from[i]]) < 0)
+				{
+					to[out++] = from[j++];
+				}
+				else
+				{
+					to[out++] = from[i++];
+				}
+			}
+			while (i < mid)
+			{
+				to[out++] = from[i++];
+			}
+			while (j < high)
+			{
+				to[out++] = from[j++];
+			}
+		}
+
+		int *tmp = from;
+		from = to;
+		to = tmp;
+	}
+
+	// The result is in from, which may be the scratch array.
+	if (from != order)
+	{
+		memcpy(order, from, n * sizeof(int));
+		free(from);
+	}
+	else
+	{
+		free(to);
+	}
+}
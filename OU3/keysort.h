@@ -0,0 +1,33 @@
+#ifndef __KEYSORT_H
+#define __KEYSORT_H
+
+#include "util.h"
+
+/*
+ * Stable sorting of key arrays by a table compare function. Used by
+ * the table implementations to process batches of keys in one sorted
+ * pass. qsort() cannot be used since its compare function has no way
+ * to reach the compare function of the table.
+ *
+ * Authors: Adam Pettersson
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first public version.
+ */
+
+/**
+ * keysort() - Sort key positions by key.
+ * @keys: Array of n keys. Not modified.
+ * @order: Array of n ints. Set to the positions 0..n-1 ordered so that
+ *	   keys[order[0]] <= keys[order[1]] <= ... Equal keys keep their
+ *	   relative order, so the latest of a group of equal keys is last.
+ * @n: Number of keys.
+ * @cmp: Function used to compare keys.
+ *
+ * Runs in O(n log n) time.
+ *
+ * Returns: Nothing.
+ */
+void keysort(void *const *keys, int *order, int n, compare_function *cmp);
+
+#endif
@@ -2,15 +2,26 @@
 *Tabell konstruerad som en move to fron lista 
 *Koden från table2.c och modifiera så att när du läser av ett element i tabellen flyttas den till först i listan 
 *
+*The list is a circular doubly linked list threaded through the
+*table entries themselves, with a sentinel entry as head. Entries are
+*taken from a per-table entry_pool, so inserts and removes rarely call
+*malloc()/free() and table_kill() releases all entries slab by slab.
 */
 
 #include <stdlib.h>
 #include <stdio.h>
 #include "table.h"
-#include "dlist.h"
+#include "entry_pool.h"
 
+// head is the sentinel of the list, head->next is the first entry.
+// All entries, including head, are allocated from pool.
+//
+// size keeps track of the number of entries in the list, so that the
+// size of the table is known without walking the list.
 struct table {
-	dlist *entries;
+	struct table_entry *head;
+	entry_pool *pool;
+	int size;
 	compare_function *key_cmp_func;
 	free_function key_free_func;
 	free_function value_free_func;
@@ -19,9 +30,39 @@ struct table {
 struct table_entry {
 	void *key;
 	void *value;
+	struct table_entry *prev;
+	struct table_entry *next;
 };
 
 // ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * unlink_entry() - Take an entry out of the list.
+ * @entry: Entry to unlink.
+ *
+ * Returns: Nothing.
+ */
+static void unlink_entry(struct table_entry *entry)
+{
+	entry->prev->next = entry->next;
+	entry->next->prev = entry->prev;
+}
+
+/**
+ * link_first() - Put an entry first in the list.
+ * @t: Table to manipulate.
+ * @entry: Entry to link.
+ *
+ * Returns: Nothing.
+ */
+static void link_first(const table *t, struct table_entry *entry)
+{
+	entry->prev = t->head;
+	entry->next = t->head->next;
+	t->head->next->prev = entry;
+	t->head->next = entry;
+}
+
 /**
  * table_empty() - Create an empty table.
  * @key_cmp_func: A pointer to a function to be used to compare keys.
@@ -38,8 +79,11 @@ table *table_empty(compare_function *key_cmp_func,
 {
 	// Allocate the table header.
 	table *t = calloc(1, sizeof(table));
-	// Create the list to hold the table_entry-ies.
-	t->entries = dlist_empty(NULL);
+	// Create the pool and the empty list to hold the table_entry-ies.
+	t->pool = entry_pool_empty(sizeof(struct table_entry));
+	t->head = entry_pool_alloc(t->pool);
+	t->head->prev = t->head;
+	t->head->next = t->head;
 	// Store the key compare function and key/value free functions.
 	t->key_cmp_func = key_cmp_func;
 	t->key_free_func = key_free_func;
@@ -56,7 +100,18 @@ table *table_empty(compare_function *key_cmp_func,
  */
 bool table_is_empty(const table *t)
 {
-	return dlist_is_empty(t->entries);
+	return t->size == 0;
+}
+
+/**
+ * table_size() - Return the number of entries in a table.
+ * @t: Table to inspect.
+ *
+ * Returns: The number of key/value pairs in the table.
+ */
+int table_size(const table *t)
+{
+	return t->size;
 }
 
 /**
@@ -75,13 +130,33 @@ bool table_is_empty(const table *t)
 void table_insert(table *t, void *key, void *value)
 {
 	// Allocate the key/value structure.
-	struct table_entry *entry = malloc(sizeof(struct table_entry));
+	struct table_entry *entry = entry_pool_alloc(t->pool);
 
 	// Set the pointers and insert first in the list. This will
 	// cause table_lookup() to find the latest added value.
 	entry->key = key;
 	entry->value = value;
-	dlist_insert(t->entries, entry, dlist_first(t->entries));
+	link_first(t, entry);
+	t->size++;
+}
+
+/**
+ * table_insert_many() - Add a batch of key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n pointers to key values.
+ * @values: Array of n pointers to value values.
+ * @n: Number of pairs.
+ *
+ * table_insert() never searches the list, so there is nothing to gain
+ * from handling the batch as a whole.
+ *
+ * Returns: Nothing.
+ */
+void table_insert_many(table *t, void *const *keys, void *const *values, int n)
+{
+	for (int i = 0; i < n; i++) {
+		table_insert(t, keys[i], values[i]);
+	}
 }
 
 /**
@@ -98,31 +173,46 @@ void *table_lookup(const table *t, const void *key)
 {
     // Iterate over the list. Return first match and move it to the front.
 
-    dlist_pos pos = dlist_first(t->entries);
-    dlist_pos prev = dlist_first(t->entries);
+    struct table_entry *entry = t->head->next;
 
-    while (!dlist_is_end(t->entries, pos)) {
-        // Inspect the table entry
-        struct table_entry *entry = dlist_inspect(t->entries, pos);
+    while (entry != t->head) {
         // Check if the entry key matches the search key.
         if (t->key_cmp_func(entry->key, key) == 0) {
             // If yes, move the entry to the front of the list
-            if (!dlist_is_end(t->entries, prev)) {
-                dlist_remove(t->entries, pos);
-                dlist_insert(t->entries, entry, dlist_first(t->entries));
+            if (entry->prev != t->head) {
+                unlink_entry(entry);
+                link_first(t, entry);
             }
             // Return the corresponding value pointer.
             return entry->value;
         }
-        // Continue with the next position.
-        prev = pos;
-        pos = dlist_next(t->entries, pos);
+        // Continue with the next entry.
+        entry = entry->next;
     }
     // No match found. Return NULL.
     return NULL;
 }
 
 
+/**
+ * table_lookup_many() - Look up a batch of keys in a table.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @values: Array of n pointers, set to the value for each key or NULL.
+ * @n: Number of keys.
+ *
+ * Every lookup reorganizes the list, so the keys are looked up one at
+ * a time in array order.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_many(const table *t, void *const *keys, void **values, int n)
+{
+	for (int i = 0; i < n; i++) {
+		values[i] = table_lookup(t, keys[i]);
+	}
+}
+
 /**
  * table_choose_key() - Return an arbitrary key.
  * @t: Table to inspect.
@@ -136,10 +226,7 @@ void *table_lookup(const table *t, const void *key)
 void *table_choose_key(const table *t)
 {
 	// Return first key value.
-	dlist_pos pos = dlist_first(t->entries);
-	struct table_entry *entry = dlist_inspect(t->entries, pos);
-
-	return entry->key;
+	return t->head->next->key;
 }
 
 /**
@@ -159,12 +246,11 @@ void table_remove(table *t, const void *key)
 	void *deferred_ptr = NULL;
 
 	// Start at beginning of the list.
-	dlist_pos pos = dlist_first(t->entries);
+	struct table_entry *entry = t->head->next;
 
 	// Iterate over the list. Remove any entries with matching keys.
-	while (!dlist_is_end(t->entries, pos)) {
-		// Inspect the table entry
-		struct table_entry *entry = dlist_inspect(t->entries, pos);
+	while (entry != t->head) {
+		struct table_entry *next = entry->next;
 
 		// Compare the supplied key with the key of this entry.
 		if (t->key_cmp_func(entry->key, key) == 0) {
@@ -185,14 +271,14 @@ void table_remove(table *t, const void *key)
 			if (t->value_free_func != NULL) {
 				t->value_free_func(entry->value);
 			}
-			// Remove the list element itself.
-			pos = dlist_remove(t->entries, pos);
-			// Deallocate the table entry structure.
-			free(entry);
-		} else {
-			// No match, move on to next element in the list.
-			pos = dlist_next(t->entries, pos);
+			// Remove the list element itself and return it to
+			// the pool.
+			unlink_entry(entry);
+			entry_pool_free(t->pool, entry);
+			t->size--;
 		}
+		// Move on to next element in the list.
+		entry = next;
 	}
 	if (deferred_ptr != NULL) {
 		// Take care of the delayed free.
@@ -200,6 +286,22 @@ void table_remove(table *t, const void *key)
 	}
 }
 
+/**
+ * table_reserve() - Prepare a table to hold a number of entries.
+ * @t: Table to manipulate.
+ * @n: Expected number of entries.
+ *
+ * The entries are kept in a list and the pool grows by itself, so
+ * there is nothing to prepare and the hint is ignored.
+ *
+ * Returns: Nothing.
+ */
+void table_reserve(table *t, int n)
+{
+	(void)t;
+	(void)n;
+}
+
 /*
  * table_kill() - Destroy a table.
  * @table: Table to destroy.
@@ -213,27 +315,26 @@ void table_remove(table *t, const void *key)
  */
 void table_kill(table *t)
 {
-	// Iterate over the list. Destroy all elements.
-	dlist_pos pos = dlist_first(t->entries);
+	// The list only has to be walked if there are keys or values
+	// to free.
+	if (t->key_free_func != NULL || t->value_free_func != NULL) {
+		struct table_entry *entry = t->head->next;
 
-	while (!dlist_is_end(t->entries, pos)) {
-		// Inspect the key/value pair.
-		struct table_entry *entry = dlist_inspect(t->entries, pos);
-		// Free key and/or value if given the authority to do so.
-		if (t->key_free_func != NULL) {
-			t->key_free_func(entry->key);
-		}
-		if (t->value_free_func != NULL) {
-			t->value_free_func(entry->value);
+		while (entry != t->head) {
+			// Free key and/or value if given the authority to do so.
+			if (t->key_free_func != NULL) {
+				t->key_free_func(entry->key);
+			}
+			if (t->value_free_func != NULL) {
+				t->value_free_func(entry->value);
+			}
+			// Move on to next element.
+			entry = entry->next;
 		}
-		// Move on to next element.
-		pos = dlist_next(t->entries, pos);
-		// Deallocate the table entry structure.
-		free(entry);
 	}
 
-	// Kill what's left of the list...
-	dlist_kill(t->entries);
+	// Kill all entries at once...
+	entry_pool_kill(t->pool);
 	// ...and the table.
 	free(t);
 }
@@ -251,13 +352,12 @@ void table_kill(table *t)
 void table_print(const table *t, inspect_callback_pair print_func)
 {
 	// Iterate over all elements. Call print_func on keys/values.
-	dlist_pos pos = dlist_first(t->entries);
+	struct table_entry *e = t->head->next;
 
-	while (!dlist_is_end(t->entries, pos)) {
-		struct table_entry *e = dlist_inspect(t->entries, pos);
+	while (e != t->head) {
 		// Call print_func
 		print_func(e->key, e->value);
-		pos = dlist_next(t->entries, pos);
+		e = e->next;
 	}
 }
 
@@ -0,0 +1,572 @@
+/*
+ * Implementation of the table interface as an ordered array. The
+ * entries are kept sorted by key_cmp_func so table_lookup() is a
+ * binary search. New keys are first put in a small sorted tail that is
+ * merged into the main array in bulk when it grows past about sqrt(n)
+ * entries, so an insert costs O(sqrt(n)) amortized instead of the O(n)
+ * shifting needed to keep a single array sorted.
+ *
+ * The table is meant for read-mostly use, i.e. tables that are loaded
+ * once and then queried many times.
+ *
+ * Authors: Adam Pettersson
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first public version.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "table.h"
+#include "keysort.h"
+
+// The tail is always allowed to hold at least this many entries.
+#define MIN_TAIL_SIZE 32
+
+// Initial capacity of the main array.
+#define INITIAL_CAPACITY 64
+
+/*
+//Each table entry has a value and key and because is a
+//void pointer it can be any type of data.
+*/
+struct table_entry
+{
+	void *key;
+	void *value;
+};
+
+/*
+// entries holds size sorted entries in an array with room for
+// capacity entries. tail holds tail_size sorted entries not yet merged
+// into entries, in an array with room for tail_capacity entries. A key
+// is never in both arrays.
+*/
+struct table
+{
+	struct table_entry *entries;
+	int size;
+	int capacity;
+	struct table_entry *tail;
+	int tail_size;
+	int tail_capacity;
+	compare_function *key_cmp_func;
+	free_function key_free_func;
+	free_function value_free_func;
+};
+
+// ===========INTERNAL FUNCTION IMPLEMENTATIONS============
+
+/**
+ * search() - Binary search for a key in a sorted entry array.
+ * @t: Table the array belongs to.
+ * @entries: Sorted array to search.
+ * @n: Number of entries in the array.
+ * @key: Key to look for.
+ * @found: Set to true if the key is in the array, false otherwise.
+ *
+ * Returns: Position of the key if found, otherwise the position where
+ * the key should be inserted to keep the array sorted.
+ */
+static int search(const table *t, const struct table_entry *entries, int n,
+		  const void *key, bool *found)
+{
+	int low = 0;
+	int high = n;
+
+	while (low < high)
+	{
+		int mid = low + (high - low) / 2;
+		int cmp = t->key_cmp_func(entries[mid].key, key);
+
+		if (cmp == 0)
+		{
+			*found = true;
+			return mid;
+		}
+		if (cmp < 0)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	*found = false;
+	return low;
+}
+
+/**
+ * tail_limit() - Number of entries the tail may hold before a merge.
+ * @t: Table to inspect.
+ *
+ * Returns: The larger of MIN_TAIL_SIZE and sqrt(size).
+ */
+static int tail_limit(const table *t)
+{
+	int limit = MIN_TAIL_SIZE;
+
+	while ((long)limit * limit < t->size)
+	{
+		limit *= 2;
+	}
+
+	return limit;
+}
+
+/**
+ * merge_tail() - Merge the tail into the main array.
+ * @t: Table to manipulate.
+ *
+ * Both arrays are sorted, so they are merged from the back in one
+ * pass without any extra memory besides the grown main array.
+ *
+ * Returns: Nothing.
+ */
+static void merge_tail(table *t)
+{
+	int total = t->size + t->tail_size;
+
+	if (total > t->capacity)
+	{
+		while (total > t->capacity)
+		{
+			t->capacity *= 2;
+		}
+		t->entries = realloc(t->entries, t->capacity * sizeof(struct table_entry));
+	}
+
+	int i = t->size - 1;
+	int j = t->tail_size - 1;
+	int out = total - 1;
+
+	// Once the tail is used up the rest of the main array is
+	// already in place.
+	while (j >= 0)
+	{
+		if (i >= 0 && t->key_cmp_func(t->entries[i].key, t->tail[j].key) > 0)
+		{
+			t->entries[out--] = t->entries[i--];
+		}
+		else
+		{
+			t->entries[out--] = t->tail[j--];
+		}
+	}
+
+	t->size = total;
+	t->tail_size = 0;
+}
+
+/**
+ * free_entry() - Call any free functions on a key/value pair.
+ * @t: Table the entry belongs to.
+ * @entry: Entry to free.
+ *
+ * Returns: Nothing.
+ */
+static void free_entry(const table *t, struct table_entry *entry)
+{
+	if (t->key_free_func != NULL)
+	{
+		t->key_free_func(entry->key);
+	}
+	if (t->value_free_func != NULL)
+	{
+		t->value_free_func(entry->value);
+	}
+}
+
+/**
+ * replace_entry() - Replace the key/value pair of an existing entry.
+ * @t: Table the entry belongs to.
+ * @entry: Entry to update.
+ * @key: New key.
+ * @value: New value.
+ *
+ * Any free functions are called on the old pair, but never on the
+ * memory that is being inserted.
+ *
+ * Returns: Nothing.
+ */
+static void replace_entry(const table *t, struct table_entry *entry, void *key, void *value)
+{
+	if (t->key_free_func != NULL && entry->key != key)
+	{
+		t->key_free_func(entry->key);
+	}
+	if (t->value_free_func != NULL && entry->value != value)
+	{
+		t->value_free_func(entry->value);
+	}
+	entry->key = key;
+	entry->value = value;
+}
+
+// ===========PUBLIC FUNCTION IMPLEMENTATIONS============
+
+/**
+ * table_empty() - Create an empty table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty(compare_function *key_cmp_func,
+		   free_function key_free_func,
+		   free_function value_free_func)
+{
+	// Allocate the table header.
+	table *t = malloc(sizeof(table));
+
+	// Store the key compare function and key/value free functions.
+	t->key_cmp_func = key_cmp_func;
+	t->key_free_func = key_free_func;
+	t->value_free_func = value_free_func;
+
+	// Create the main array and the tail.
+	t->capacity = INITIAL_CAPACITY;
+	t->entries = malloc(t->capacity * sizeof(struct table_entry));
+	t->size = 0;
+	t->tail_capacity = MIN_TAIL_SIZE;
+	t->tail = malloc(t->tail_capacity * sizeof(struct table_entry));
+	t->tail_size = 0;
+
+	return t;
+}
+
+/**
+ * table_is_empty() - Check if a table is empty.
+ * @table: Table to check.
+ *
+ * Returns: True if table contains no key/value pairs, false otherwise.
+ */
+bool table_is_empty(const table *t)
+{
+	return t->size == 0 && t->tail_size == 0;
+}
+
+/**
+ * table_size() - Return the number of entries in a table.
+ * @t: Table to inspect.
+ *
+ * Returns: The number of key/value pairs in the table.
+ */
+int table_size(const table *t)
+{
+	return t->size + t->tail_size;
+}
+
+/**
+ * table_insert() - Add a key/value pair to a table.
+ * @table: Table to manipulate.
+ * @key: A pointer to the key value.
+ * @value: A pointer to the value value.
+ *
+ * Insert the key/value pair into the table. If the key is already in
+ * the table, the old key/value pair is replaced and any free
+ * functions set for keys/values are called on the old pair.
+ *
+ * Returns: Nothing.
+ */
+void table_insert(table *t, void *key, void *value)
+{
+	bool found;
+
+	// Replace in place if the key is in the main array...
+	int pos = search(t, t->entries, t->size, key, &found);
+	if (found)
+	{
+		replace_entry(t, &t->entries[pos], key, value);
+		return;
+	}
+
+	// ...or in the tail.
+	pos = search(t, t->tail, t->tail_size, key, &found);
+	if (found)
+	{
+		replace_entry(t, &t->tail[pos], key, value);
+		return;
+	}
+
+	// New key, insert it in sorted order in the tail.
+	if (t->tail_size == t->tail_capacity)
+	{
+		t->tail_capacity *= 2;
+		t->tail = realloc(t->tail, t->tail_capacity * sizeof(struct table_entry));
+	}
+	memmove(&t->tail[pos + 1], &t->tail[pos],
+		(t->tail_size - pos) * sizeof(struct table_entry));
+	t->tail[pos].key = key;
+	t->tail[pos].value = value;
+	t->tail_size++;
+
+	if (t->tail_size >= tail_limit(t))
+	{
+		merge_tail(t);
+	}
+}
+
+/**
+ * table_insert_many() - Add a batch of key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n pointers to key values.
+ * @values: Array of n pointers to value values.
+ * @n: Number of pairs.
+ *
+ * Same result as calling table_insert() for each pair in order. The
+ * batch is sorted, keys already in the table are replaced in place and
+ * the new keys are merged into the main array in a single pass, so a
+ * bulk load costs O(n log n + size).
+ *
+ * Returns: Nothing.
+ */
+void table_insert_many(table *t, void *const *keys, void *const *values, int n)
+{
+	int *order = malloc((n > 0 ? n : 1) * sizeof(int));
+	keysort(keys, order, n, t->key_cmp_func);
+
+	// Start with an empty tail so that every key of the batch is
+	// either in the main array or new.
+	if (t->tail_size > 0)
+	{
+		merge_tail(t);
+	}
+
+	int group = 0;
+	while (group < n)
+	{
+		// order[group..group_end-1] are equal keys in batch order.
+		int group_end = group + 1;
+		while (group_end < n && t->key_cmp_func(keys[order[group]], keys[order[group_end]]) == 0)
+		{
+			group_end++;
+		}
+
+		// Each occurrence replaces the previous one.
+		for (int g = group + 1; g < group_end; g++)
+		{
+			struct table_entry replaced = {keys[order[g - 1]], values[order[g - 1]]};
+			replace_entry(t, &replaced, keys[order[g]], values[order[g]]);
+		}
+
+		// The latest occurrence replaces the key in the main array,
+		// or is appended to the tail. The batch is sorted and the
+		// tail was empty, so the tail stays sorted.
+		int latest = order[group_end - 1];
+		bool found;
+		int pos = search(t, t->entries, t->size, keys[latest], &found);
+		if (found)
+		{
+			replace_entry(t, &t->entries[pos], keys[latest], values[latest]);
+		}
+		else
+		{
+			if (t->tail_size == t->tail_capacity)
+			{
+				t->tail_capacity *= 2;
+				t->tail = realloc(t->tail, t->tail_capacity * sizeof(struct table_entry));
+			}
+			t->tail[t->tail_size].key = keys[latest];
+			t->tail[t->tail_size].value = values[latest];
+			t->tail_size++;
+		}
+
+		group = group_end;
+	}
+
+	if (t->tail_size > 0)
+	{
+		merge_tail(t);
+	}
+
+	free(order);
+}
+
+/**
+ * table_lookup() - Look up a given key in a table.
+ * @table: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The value corresponding to a given key, or NULL if the key
+ * is not found in the table.
+ */
+void *table_lookup(const table *t, const void *key)
+{
+	bool found;
+
+	int pos = search(t, t->entries, t->size, key, &found);
+	if (found)
+	{
+		return t->entries[pos].value;
+	}
+
+	pos = search(t, t->tail, t->tail_size, key, &found);
+	if (found)
+	{
+		return t->tail[pos].value;
+	}
+
+	return NULL;
+}
+
+/**
+ * table_lookup_many() - Look up a batch of keys in a table.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @values: Array of n pointers, set to the value for each key or NULL.
+ * @n: Number of keys.
+ *
+ * Each key is already found in O(log n) time, so the keys are simply
+ * looked up one at a time.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_many(const table *t, void *const *keys, void **values, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		values[i] = table_lookup(t, keys[i]);
+	}
+}
+
+/**
+ * table_choose_key() - Return an arbitrary key.
+ * @t: Table to inspect.
+ *
+ * Return an arbitrary key stored in the table. Can be used together
+ * with table_remove() to deconstruct the table. Undefined for an
+ * empty table.
+ *
+ * Returns: An arbitrary key stored in the table.
+ */
+void *table_choose_key(const table *t)
+{
+	// The last entry is the cheapest one to remove.
+	if (t->tail_size > 0)
+	{
+		return t->tail[t->tail_size - 1].key;
+	}
+	if (t->size > 0)
+	{
+		return t->entries[t->size - 1].key;
+	}
+
+	return NULL;
+}
+
+/**
+ * table_remove() - Remove a key/value pair in the table.
+ * @table: Table to manipulate.
+ * @key: Key for which to remove pair.
+ *
+ * Will call any free functions set for keys/values. Does nothing if
+ * key is not found in the table.
+ *
+ * Returns: Nothing.
+ */
+void table_remove(table *t, const void *key)
+{
+	bool found;
+	struct table_entry removed;
+
+	int pos = search(t, t->entries, t->size, key, &found);
+	if (found)
+	{
+		removed = t->entries[pos];
+		memmove(&t->entries[pos], &t->entries[pos + 1],
+			(t->size - pos - 1) * sizeof(struct table_entry));
+		t->size--;
+	}
+	else
+	{
+		pos = search(t, t->tail, t->tail_size, key, &found);
+		if (!found)
+		{
+			return;
+		}
+		removed = t->tail[pos];
+		memmove(&t->tail[pos], &t->tail[pos + 1],
+			(t->tail_size - pos - 1) * sizeof(struct table_entry));
+		t->tail_size--;
+	}
+
+	// The key may be the same memory as the key given by the caller,
+	// so the entry is freed only after it has been taken out.
+	free_entry(t, &removed);
+}
+
+/**
+ * table_reserve() - Prepare a table to hold a number of entries.
+ * @t: Table to manipulate.
+ * @n: Expected number of entries.
+ *
+ * Grows the main array to hold at least n entries so that merging
+ * the tail does not have to reallocate it while the table is loaded.
+ *
+ * Returns: Nothing.
+ */
+void table_reserve(table *t, int n)
+{
+	if (t->capacity < n)
+	{
+		t->capacity = n;
+		t->entries = realloc(t->entries, t->capacity * sizeof(struct table_entry));
+	}
+}
+
+/*
+ * table_kill() - Destroy a table.
+ * @table: Table to destroy.
+ *
+ * Return all dynamic memory used by the table and its elements. If a
+ * free_func was registered for keys and/or values at table creation,
+ * it is called each element to free any user-allocated memory
+ * occupied by the element values.
+ *
+ * Returns: Nothing.
+ */
+void table_kill(table *t)
+{
+	for (int i = 0; i < t->size; i++)
+	{
+		free_entry(t, &t->entries[i]);
+	}
+	for (int i = 0; i < t->tail_size; i++)
+	{
+		free_entry(t, &t->tail[i]);
+	}
+
+	free(t->entries);
+	free(t->tail);
+	free(t);
+}
+
+/**
+ * table_print() - Print the given table.
+ * @t: Table to print.
+ * @print_func: Function called for each key/value pair in the table.
+ *
+ * Iterates over the key/value pairs in the table and prints them.
+ * Pairs in the main array are printed in key order, followed by any
+ * pairs not yet merged from the tail.
+ *
+ * Returns: Nothing.
+ */
+void table_print(const table *t, inspect_callback_pair print_func)
+{
+	for (int i = 0; i < t->size; i++)
+	{
+		print_func(t->entries[i].key, t->entries[i].value);
+	}
+	for (int i = 0; i < t->tail_size; i++)
+	{
+		print_func(t->tail[i].key, t->tail[i].value);
+	}
+}
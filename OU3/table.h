@@ -0,0 +1,195 @@
+#ifndef __TABLE_H
+#define __TABLE_H
+
+#include <stdbool.h>
+#include "util.h"
+
+/*
+ * Declaration of a generic table for the "Datastructures and
+ * algorithms" courses at the Department of Computing Science, Umea
+ * University. The table stores void pointers to keys and values. The
+ * user of the table is responsible for providing a function to
+ * compare keys. After use, the function table_kill() must be called
+ * to de-allocate the dynamic memory used by the table itself. The
+ * de-allocation of any dynamic memory allocated for the key and/or
+ * value values is the responsibility of the user of the table, unless
+ * a corresponding kill_function is registered in table_empty().
+ *
+ * The interface is the one from the course codebase, with the
+ * additions listed below. The additions are implemented by every
+ * table implementation in this directory.
+ *
+ * Authors: Niclas Borlin (niclas@cs.umu.se)
+ *	    Adam Dahlgren Lindstrom (dali@cs.umu.se)
+ *	    Adam Pettersson (additions)
+ *
+ * Version information:
+ *   2026-10-16: Added table_reserve().
+ *   2026-10-16: Added table_size().
+ *   2026-10-16: Added table_insert_many() and table_lookup_many().
+ */
+
+// ====================== PUBLIC DATA TYPES ==========================
+
+// Anonymous declaration of table.
+typedef struct table table;
+
+// ====================== TABLE INTERFACE ==========================
+
+/**
+ * table_empty() - Create an empty table.
+ * @key_cmp_func: A pointer to a function to be used to compare keys.
+ * @key_free_func: A pointer to a function (or NULL) to be called to
+ *		   de-allocate memory for keys on remove/kill.
+ * @value_free_func: A pointer to a function (or NULL) to be called to
+ *		     de-allocate memory for values on remove/kill.
+ *
+ * Returns: Pointer to a new table.
+ */
+table *table_empty(compare_function *key_cmp_func,
+		   free_function key_free_func,
+		   free_function value_free_func);
+
+/**
+ * table_is_empty() - Check if a table is empty.
+ * @table: Table to check.
+ *
+ * Returns: True if table contains no key/value pairs, false otherwise.
+ */
+bool table_is_empty(const table *t);
+
+/**
+ * table_insert() - Add a key/value pair to a table.
+ * @table: Table to manipulate.
+ * @key: A pointer to the key value.
+ * @value: A pointer to the value value.
+ *
+ * Insert the key/value pair into the table. No test is performed to
+ * check if key is a duplicate. table_lookup() will return the latest
+ * added value for a duplicate key. table_remove() will remove all
+ * duplicates for a given key.
+ *
+ * Returns: Nothing.
+ */
+void table_insert(table *t, void *key, void *value);
+
+/**
+ * table_lookup() - Look up a given key in a table.
+ * @table: Table to inspect.
+ * @key: Key to look up.
+ *
+ * Returns: The value corresponding to a given key, or NULL if the key
+ * is not found in the table. If the table contains duplicate keys,
+ * the value that was latest inserted will be returned.
+ */
+void *table_lookup(const table *t, const void *key);
+
+/**
+ * table_choose_key() - Return an arbitrary key.
+ * @t: Table to inspect.
+ *
+ * Return an arbitrary key stored in the table. Can be used together
+ * with table_remove() to deconstruct the table. Undefined for an
+ * empty table.
+ *
+ * Returns: An arbitrary key stored in the table.
+ */
+void *table_choose_key(const table *t);
+
+/**
+ * table_remove() - Remove a key/value pair in the table.
+ * @table: Table to manipulate.
+ * @key: Key for which to remove pair.
+ *
+ * Any matching duplicates will be removed. Will call any free
+ * functions set for keys/values. Does nothing if key is not found in
+ * the table.
+ *
+ * Returns: Nothing.
+ */
+void table_remove(table *t, const void *key);
+
+/*
+ * table_kill() - Destroy a table.
+ * @table: Table to destroy.
+ *
+ * Return all dynamic memory used by the table and its elements. If a
+ * free_func was registered for keys and/or values at table creation,
+ * it is called each element to free any user-allocated memory
+ * occupied by the element values.
+ *
+ * Returns: Nothing.
+ */
+void table_kill(table *t);
+
+/**
+ * table_print() - Print the given table.
+ * @t: Table to print.
+ * @print_func: Function called for each key/value pair in the table.
+ *
+ * Iterates over the key/value pairs in the table and prints them.
+ * Will print all stored elements, including duplicates.
+ *
+ * Returns: Nothing.
+ */
+void table_print(const table *t, inspect_callback_pair print_func);
+
+// ====================== ADDITIONS ==========================
+
+/**
+ * table_size() - Return the number of entries in a table.
+ * @t: Table to inspect.
+ *
+ * Duplicates are counted once for each stored key/value pair, i.e.
+ * the number of pairs table_print() would print. Runs in O(1).
+ *
+ * Returns: The number of key/value pairs in the table.
+ */
+int table_size(const table *t);
+
+/**
+ * table_reserve() - Prepare a table to hold a number of entries.
+ * @t: Table to manipulate.
+ * @n: Expected number of entries.
+ *
+ * A hint only. Implementations with an array of entries make room for
+ * at least n entries up front so that they do not have to grow while
+ * the entries are inserted, and keep that room when entries are
+ * removed. Implementations without such an array ignore the hint.
+ *
+ * Returns: Nothing.
+ */
+void table_reserve(table *t, int n);
+
+/**
+ * table_insert_many() - Add a batch of key/value pairs to a table.
+ * @t: Table to manipulate.
+ * @keys: Array of n pointers to key values.
+ * @values: Array of n pointers to value values.
+ * @n: Number of pairs.
+ *
+ * Has the same effect as calling table_insert() for each pair in
+ * array order, but lets the implementation de-duplicate, sort or hash
+ * the whole batch at once instead of searching the table once per
+ * key.
+ *
+ * Returns: Nothing.
+ */
+void table_insert_many(table *t, void *const *keys, void *const *values, int n);
+
+/**
+ * table_lookup_many() - Look up a batch of keys in a table.
+ * @t: Table to inspect.
+ * @keys: Array of n keys to look up.
+ * @values: Array of n pointers. values[i] is set to the value
+ *	    table_lookup() would return for keys[i].
+ * @n: Number of keys.
+ *
+ * Self-organizing tables reorganize as if table_lookup() had been
+ * called for each key in array order.
+ *
+ * Returns: Nothing.
+ */
+void table_lookup_many(const table *t, void *const *keys, void **values, int n);
+
+#endif
@@ -0,0 +1,665 @@
+/*
+ * Benchmark program for the implementations of the table interface in
+ * this directory. The program is linked with exactly one table
+ * implementation, loads it with N keys and then runs a number of
+ * insert/lookup/remove operations where the keys are drawn from a
+ * chosen access distribution. Finally the table is drained with
+ * table_choose_key() and table_remove().
+ *
+ * For every phase and operation type the program reports the mean
+ * time per operation and the 50th/90th/99th percentile and maximum
+ * latency. The peak resident memory of the process is reported at the
+ * end, together with the peak before the table was created.
+ *
+ * Build with one table implementation, e.g.:
+ *   gcc -std=c99 -O2 -o bench_array table_bench.c arraytable.c \
+ *       keysort.c -lm
+ *   gcc -std=c99 -O2 -o bench_mtf table_bench.c mtftable.c \
+ *       entry_pool.c -lm
+ *   gcc -std=c99 -O2 -o bench_sorted table_bench.c sortedtable.c \
+ *       keysort.c -lm
+ *   gcc -std=c99 -O2 -DBENCH_HASHTABLE -o bench_hash table_bench.c \
+ *       hashtable.c -lm
+ *   gcc -std=c99 -O2 -DBENCH_POLICY=POLICY_COUNT -o bench_count \
+ *       table_bench.c arraymtftable.c -lm
+ *
+ * Usage: bench [-n keys] [-o ops] [-k int|string] [-m ins:look:rem]
+ *              [-d uniform|zipf|seq|adversarial] [-z exponent]
+ *              [-s seed] [-r] [-b]
+ *
+ * -r calls table_reserve() before the load, -b loads all keys with one
+ * call to table_insert_many(). The load latencies are then the batch
+ * time divided evenly over the keys.
+ *
+ * Authors: Adam Pettersson
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first public version.
+ *   2026-10-16: v1.1, added -b for batched loading.
+ *   2026-10-16: v1.2, Zipf ranks given to the keys by a shuffle, -k
+ *               rejects unknown key types.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <time.h>
+#include <math.h>
+#include <sys/resource.h>
+#include "table.h"
+#ifdef BENCH_HASHTABLE
+#include "hashtable.h"
+#endif
+#ifdef BENCH_POLICY
+#include "arraymtftable.h"
+#endif
+
+#define MAX_KEY_LENGTH 16
+
+enum distribution
+{
+	DIST_UNIFORM,
+	DIST_ZIPF,
+	DIST_SEQ,
+	DIST_ADVERSARIAL
+};
+
+enum operation
+{
+	OP_INSERT,
+	OP_LOOKUP,
+	OP_REMOVE
+};
+
+/*
+// The settings given on the command line.
+*/
+struct settings
+{
+	int n;
+	int ops;
+	bool string_keys;
+	int mix[3];
+	enum distribution dist;
+	double zipf_exponent;
+	unsigned long long seed;
+	bool reserve;
+	bool batch;
+};
+
+/*
+// All keys that can be used by the benchmark. Key number i is
+// int_keys[i] or string_keys[i]. Keys 0..n-1 are loaded before the
+// operations start, keys from n and up are used by OP_INSERT.
+//
+// load_order is the (shuffled) order in which keys 0..n-1 are loaded,
+// zipf_cdf and zipf_keys describe the Zipf distribution over them.
+*/
+struct keyset
+{
+	int count;
+	int *int_keys;
+	char **string_keys;
+	int *load_order;
+	double *zipf_cdf;
+	int *zipf_keys;
+};
+
+/*
+// Latencies in nanoseconds for one kind of operation.
+*/
+struct samples
+{
+	long *ns;
+	int count;
+};
+
+void parse_settings(int argc, char **argv, struct settings *s);
+struct keyset *keyset_create(const struct settings *s);
+void keyset_kill(struct keyset *k);
+void *key_ptr(const struct keyset *k, const struct settings *s, int i);
+int next_key(const struct keyset *k, const struct settings *s, int step);
+table *create_table(const struct settings *s);
+long now_ns(void);
+long peak_memory_kb(void);
+void report(const char *name, struct samples *samples);
+unsigned long long next_random(void);
+void shuffle(int *a, int n);
+int int_compare(const void *k1, const void *k2);
+int string_compare(const void *k1, const void *k2);
+unsigned long int_hash(const void *k);
+unsigned long string_hash(const void *k);
+
+// State of the pseudo random number generator (xorshift64*).
+static unsigned long long random_state = 88172645463325252ULL;
+
+/**
+ * main() - Run the benchmark.
+ * @argc: Number of command arguments.
+ * @argv: Array of command arguments.
+ *
+ * Returns: 0 if everything works out.
+ */
+int main(int argc, char **argv)
+{
+	struct settings s;
+	parse_settings(argc, argv, &s);
+	random_state = s.seed;
+
+	struct keyset *k = keyset_create(&s);
+	long base_memory = peak_memory_kb();
+
+	struct samples load = {malloc(s.n * sizeof(long)), 0};
+	struct samples op_samples[3];
+	for (int op = 0; op < 3; op++)
+	{
+		op_samples[op].ns = malloc((s.ops > 0 ? s.ops : 1) * sizeof(long));
+		op_samples[op].count = 0;
+	}
+
+	table *t = create_table(&s);
+	if (s.reserve)
+	{
+		table_reserve(t, s.n);
+	}
+
+	// Load phase.
+	if (s.batch)
+	{
+		void **keys = malloc(s.n * sizeof(void *));
+		for (int i = 0; i < s.n; i++)
+		{
+			keys[i] = key_ptr(k, &s, k->load_order[i]);
+		}
+		long start = now_ns();
+		table_insert_many(t, keys, keys, s.n);
+		long per_key = (now_ns() - start) / s.n;
+		while (load.count < s.n)
+		{
+			load.ns[load.count++] = per_key;
+		}
+		free(keys);
+	}
+	else
+	{
+		for (int i = 0; i < s.n; i++)
+		{
+			void *key = key_ptr(k, &s, k->load_order[i]);
+			long start = now_ns();
+			table_insert(t, key, key);
+			load.ns[load.count++] = now_ns() - start;
+		}
+	}
+
+	// Operation phase.
+	int total_mix = s.mix[OP_INSERT] + s.mix[OP_LOOKUP] + s.mix[OP_REMOVE];
+	int next_new_key = s.n;
+	long hits = 0;
+	for (int i = 0; i < s.ops; i++)
+	{
+		int r = next_random() % total_mix;
+		enum operation op = r < s.mix[OP_INSERT] ? OP_INSERT
+			: r < s.mix[OP_INSERT] + s.mix[OP_LOOKUP] ? OP_LOOKUP
+			: OP_REMOVE;
+		void *key = key_ptr(k, &s, op == OP_INSERT ? next_new_key++ : next_key(k, &s, i));
+
+		long start = now_ns();
+		switch (op)
+		{
+		case OP_INSERT:
+			table_insert(t, key, key);
+			break;
+		case OP_LOOKUP:
+			hits += table_lookup(t, key) != NULL;
+			break;
+		case OP_REMOVE:
+			table_remove(t, key);
+			break;
+		}
+		op_samples[op].ns[op_samples[op].count++] = now_ns() - start;
+	}
+
+	// Drain phase.
+	int drained = table_size(t);
+	struct samples drain = {malloc((drained > 0 ? drained : 1) * sizeof(long)), 0};
+	long drain_start = now_ns();
+	while (!table_is_empty(t))
+	{
+		long start = now_ns();
+		table_remove(t, table_choose_key(t));
+		drain.ns[drain.count++] = now_ns() - start;
+	}
+	long drain_total = now_ns() - drain_start;
+
+	long peak_memory = peak_memory_kb();
+	table_kill(t);
+
+	printf("keys=%d ops=%d key_type=%s mix=%d:%d:%d dist=%d seed=%llu\n",
+	       s.n, s.ops, s.string_keys ? "string" : "int",
+	       s.mix[OP_INSERT], s.mix[OP_LOOKUP], s.mix[OP_REMOVE], (int)s.dist, s.seed);
+	printf("%-8s %10s %10s %10s %10s %10s %10s\n",
+	       "phase", "count", "ns/op", "p50", "p90", "p99", "max");
+	report("load", &load);
+	report("insert", &op_samples[OP_INSERT]);
+	report("lookup", &op_samples[OP_LOOKUP]);
+	report("remove", &op_samples[OP_REMOVE]);
+	report("drain", &drain);
+	printf("lookup hits: %ld of %d\n", hits, op_samples[OP_LOOKUP].count);
+	printf("drain total: %.3f ms for %d entries\n", drain_total / 1e6, drained);
+	printf("peak memory: %ld kB (%ld kB before the table was created)\n",
+	       peak_memory, base_memory);
+
+	for (int op = 0; op < 3; op++)
+	{
+		free(op_samples[op].ns);
+	}
+	free(load.ns);
+	free(drain.ns);
+	keyset_kill(k);
+
+	return 0;
+}
+
+/**
+ * parse_settings() - Read the settings from the command line.
+ * @argc: Number of command arguments.
+ * @argv: Array of command arguments.
+ * @s: Settings to fill in.
+ *
+ * Exits the program with an error message on an unknown option.
+ */
+void parse_settings(int argc, char **argv, struct settings *s)
+{
+	s->n = 10000;
+	s->ops = 100000;
+	s->string_keys = false;
+	s->mix[OP_INSERT] = 0;
+	s->mix[OP_LOOKUP] = 100;
+	s->mix[OP_REMOVE] = 0;
+	s->dist = DIST_UNIFORM;
+	s->zipf_exponent = 1.0;
+	s->seed = 1;
+	s->reserve = false;
+	s->batch = false;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "n:o:k:m:d:z:s:rb")) != -1)
+	{
+		switch (opt)
+		{
+		case 'n':
+			s->n = atoi(optarg);
+			break;
+		case 'o':
+			s->ops = atoi(optarg);
+			break;
+		case 'k':
+			if (strcmp(optarg, "int") == 0)
+				s->string_keys = false;
+			else if (strcmp(optarg, "string") == 0)
+				s->string_keys = true;
+			else
+			{
+				fprintf(stderr, "ERROR: unknown key type %s\n", optarg);
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 'm':
+			if (sscanf(optarg, "%d:%d:%d", &s->mix[OP_INSERT], &s->mix[OP_LOOKUP],
+				   &s->mix[OP_REMOVE]) != 3)
+			{
+				fprintf(stderr, "ERROR: mix must be given as ins:look:rem\n");
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 'd':
+			if (strcmp(optarg, "uniform") == 0)
+				s->dist = DIST_UNIFORM;
+			else if (strcmp(optarg, "zipf") == 0)
+				s->dist = DIST_ZIPF;
+			else if (strcmp(optarg, "seq") == 0)
+				s->dist = DIST_SEQ;
+			else if (strcmp(optarg, "adversarial") == 0)
+				s->dist = DIST_ADVERSARIAL;
+			else
+			{
+				fprintf(stderr, "ERROR: unknown distribution %s\n", optarg);
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 'z':
+			s->zipf_exponent = atof(optarg);
+			break;
+		case 's':
+			s->seed = strtoull(optarg, NULL, 10);
+			break;
+		case 'r':
+			s->reserve = true;
+			break;
+		case 'b':
+			s->batch = true;
+			break;
+		default:
+			fprintf(stderr, "Usage: %s [-n keys] [-o ops] [-k int|string] [-m ins:look:rem]"
+				" [-d uniform|zipf|seq|adversarial] [-z exponent] [-s seed] [-r] [-b]\n", argv[0]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (s->n < 1 || s->ops < 0 || s->mix[OP_INSERT] + s->mix[OP_LOOKUP] + s->mix[OP_REMOVE] <= 0)
+	{
+		fprintf(stderr, "ERROR: need at least one key and a non-empty mix\n");
+		exit(EXIT_FAILURE);
+	}
+	if (s->seed == 0)
+	{
+		// xorshift never leaves the all zero state.
+		s->seed = 1;
+	}
+}
+
+/**
+ * keyset_create() - Create all keys used by the benchmark.
+ * @s: Benchmark settings.
+ *
+ * Returns: The keys, the load order and the Zipf distribution.
+ */
+struct keyset *keyset_create(const struct settings *s)
+{
+	struct keyset *k = calloc(1, sizeof(struct keyset));
+
+	// Every insert in the operation phase uses a new key.
+	k->count = s->n + s->ops;
+	if (s->string_keys)
+	{
+		k->string_keys = malloc(k->count * sizeof(char *));
+		for (int i = 0; i < k->count; i++)
+		{
+			k->string_keys[i] = malloc(MAX_KEY_LENGTH);
+			snprintf(k->string_keys[i], MAX_KEY_LENGTH, "key%d", i);
+		}
+	}
+	else
+	{
+		k->int_keys = malloc(k->count * sizeof(int));
+		for (int i = 0; i < k->count; i++)
+		{
+			k->int_keys[i] = i;
+		}
+	}
+
+	// Load the keys in random order so that key order, load order
+	// and access order differ.
+	k->load_order = malloc(s->n * sizeof(int));
+	for (int i = 0; i < s->n; i++)
+	{
+		k->load_order[i] = i;
+	}
+	shuffle(k->load_order, s->n);
+
+	if (s->dist == DIST_ZIPF)
+	{
+		// Rank r has weight 1/r^exponent. The ranks are given to the
+		// keys in a shuffle of their own, so the most popular keys are
+		// spread out over the load order.
+		k->zipf_cdf = malloc(s->n * sizeof(double));
+		k->zipf_keys = malloc(s->n * sizeof(int));
+		memcpy(k->zipf_keys, k->load_order, s->n * sizeof(int));
+		shuffle(k->zipf_keys, s->n);
+		double sum = 0;
+		for (int r = 0; r < s->n; r++)
+		{
+			double weight = 1.0 / pow(r + 1, s->zipf_exponent);
+			sum += weight;
+			k->zipf_cdf[r] = sum;
+		}
+		for (int r = 0; r < s->n; r++)
+		{
+			k->zipf_cdf[r] /= sum;
+		}
+	}
+
+	return k;
+}
+
+/**
+ * keyset_kill() - Free all keys.
+ * @k: Keys to free.
+ */
+void keyset_kill(struct keyset *k)
+{
+	if (k->string_keys != NULL)
+	{
+		for (int i = 0; i < k->count; i++)
+		{
+			free(k->string_keys[i]);
+		}
+		free(k->string_keys);
+	}
+	free(k->int_keys);
+	free(k->load_order);
+	free(k->zipf_cdf);
+	free(k->zipf_keys);
+	free(k);
+}
+
+/**
+ * key_ptr() - Return the pointer used as key number i in the table.
+ * @k: All keys.
+ * @s: Benchmark settings.
+ * @i: Key number.
+ *
+ * Returns: Pointer to an int or a string.
+ */
+void *key_ptr(const struct keyset *k, const struct settings *s, int i)
+{
+	if (s->string_keys)
+	{
+		return k->string_keys[i];
+	}
+	return &k->int_keys[i];
+}
+
+/**
+ * next_key() - Draw the key for a lookup or remove operation.
+ * @k: All keys.
+ * @s: Benchmark settings.
+ * @step: Number of the operation.
+ *
+ * uniform draws any loaded key with equal probability, zipf draws a
+ * few keys much more often than the rest, seq walks the keys in key
+ * order, and adversarial walks the keys in load order. The latter
+ * always asks for the least recently used key, which is the worst
+ * case for a move-to-front list.
+ *
+ * Returns: Key number.
+ */
+int next_key(const struct keyset *k, const struct settings *s, int step)
+{
+	switch (s->dist)
+	{
+	case DIST_UNIFORM:
+		return next_random() % s->n;
+	case DIST_ZIPF:
+	{
+		double u = (next_random() >> 11) * (1.0 / 9007199254740992.0);
+		int low = 0;
+		int high = s->n - 1;
+		while (low < high)
+		{
+			int mid = (low + high) / 2;
+			if (k->zipf_cdf[mid] < u)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+		return k->zipf_keys[low];
+	}
+	case DIST_SEQ:
+		return step % s->n;
+	case DIST_ADVERSARIAL:
+		return k->load_order[step % s->n];
+	}
+	return 0;
+}
+
+/**
+ * create_table() - Create the table under test.
+ * @s: Benchmark settings.
+ *
+ * Returns: An empty table without free functions, the benchmark owns
+ * all keys.
+ */
+table *create_table(const struct settings *s)
+{
+	compare_function *cmp = s->string_keys ? string_compare : int_compare;
+#if defined(BENCH_HASHTABLE)
+	return table_empty_hash(cmp, s->string_keys ? string_hash : int_hash, NULL, NULL);
+#elif defined(BENCH_POLICY)
+	return table_empty_policy(cmp, BENCH_POLICY, 4, NULL, NULL);
+#else
+	return table_empty(cmp, NULL, NULL);
+#endif
+}
+
+/**
+ * now_ns() - Read the monotonic clock.
+ *
+ * Returns: The current time in nanoseconds.
+ */
+long now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+/**
+ * peak_memory_kb() - Return the peak resident memory of the process.
+ *
+ * Returns: Peak resident set size in kB.
+ */
+long peak_memory_kb(void)
+{
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+}
+
+/**
+ * compare_long() - Compare function for qsort() on latencies.
+ */
+static int compare_long(const void *a, const void *b)
+{
+	long x = *(const long *)a;
+	long y = *(const long *)b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * report() - Print mean and percentile latencies for one phase.
+ * @name: Name of the phase.
+ * @samples: Latencies for the phase. Sorted by the call.
+ */
+void report(const char *name, struct samples *samples)
+{
+	if (samples->count == 0)
+	{
+		printf("%-8s %10d %10s %10s %10s %10s %10s\n", name, 0, "-", "-", "-", "-", "-");
+		return;
+	}
+
+	long sum = 0;
+	for (int i = 0; i < samples->count; i++)
+	{
+		sum += samples->ns[i];
+	}
+	qsort(samples->ns, samples->count, sizeof(long), compare_long);
+
+	int n = samples->count;
+	printf("%-8s %10d %10.1f %10ld %10ld %10ld %10ld\n", name, n, (double)sum / n,
+	       samples->ns[n * 50 / 100], samples->ns[n * 90 / 100],
+	       samples->ns[n * 99 / 100], samples->ns[n - 1]);
+}
+
+/**
+ * next_random() - Return the next pseudo random number (xorshift64*).
+ *
+ * Returns: A 64 bit pseudo random number.
+ */
+unsigned long long next_random(void)
+{
+	random_state ^= random_state >> 12;
+	random_state ^= random_state << 25;
+	random_state ^= random_state >> 27;
+	return random_state * 2685821657736338717ULL;
+}
+
+/**
+ * shuffle() - Shuffle an array (Fisher-Yates).
+ * @a: Array to shuffle.
+ * @n: Number of elements in a.
+ *
+ * Returns: Nothing.
+ */
+void shuffle(int *a, int n)
+{
+	for (int i = n - 1; i > 0; i--)
+	{
+		int j = next_random() % (i + 1);
+		int tmp = a[i];
+		a[i] = a[j];
+		a[j] = tmp;
+	}
+}
+
+/**
+ * int_compare() - Compare two int keys.
+ *
+ * Returns: <0, 0 or >0 like strcmp().
+ */
+int int_compare(const void *k1, const void *k2)
+{
+	int x = *(const int *)k1;
+	int y = *(const int *)k2;
+	return (x > y) - (x < y);
+}
+
+/**
+ * string_compare() - Compare two string keys.
+ *
+ * Returns: <0, 0 or >0 like strcmp().
+ */
+int string_compare(const void *k1, const void *k2)
+{
+	return strcmp(k1, k2);
+}
+
+/**
+ * int_hash() - Hash an int key.
+ *
+ * Returns: The key itself, the hash table mixes the bits.
+ */
+unsigned long int_hash(const void *k)
+{
+	return (unsigned long)*(const int *)k;
+}
+
+/**
+ * string_hash() - Hash a string key with FNV-1a.
+ *
+ * Returns: The hash value.
+ */
+unsigned long string_hash(const void *k)
+{
+	unsigned long h = 2166136261UL;
+	for (const unsigned char *c = k; *c != '\0'; c++)
+	{
+		h = (h ^ *c) * 16777619UL;
+	}
+	return h;
+}
@@ -0,0 +1,673 @@
+/*
+ * Frozen graph in compressed sparse row (CSR) form, made from a graph
+ * by graph_freeze().
+ *
+ * The neighbours of node i are targets[offsets[i]..offsets[i+1]-1],
+ * and its predecessors are sources[in_offsets[i]..in_offsets[i+1]-1].
+ * All node names are copied into one block of characters, with the
+ * name of node i starting at names[name_offsets[i]]. A name index
+ * (open addressing with linear probing, same layout as the one in
+ * graph.c but storing ids) maps names to ids.
+ *
+ * A snapshot file is struct snapshot_header followed by the arrays
+ * offsets, targets, in_offsets, sources, name_offsets, index and names,
+ * in that order, each starting at a multiple of 8 bytes. The arrays are
+ * stored as they are in memory, so a frozen graph opened from a
+ * snapshot points its arrays straight into the mapped file. The header
+ * has a checksum of its own and one of the arrays. csr_graph_open()
+ * reads the arrays once, checking the checksum and every entry that is
+ * later used as an index, so that a damaged file is rejected rather
+ * than used or read out of bounds.
+ *
+ * Authors: Adam Pettersson
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first public version.
+ *   2026-10-16: v1.1, predecessor spans.
+ *   2026-10-16: v1.2, snapshot files.
+ *   2026-10-16: v1.3, the arrays of a snapshot are checked on open.
+ *   2026-10-16: v1.4, checksum of the arrays of a snapshot.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "dlist.h"
+#include "graph.h"
+#include "csr_graph.h"
+#include "name_hash.h"
+
+struct csr_graph
+{
+	int node_count;
+	int edge_count;
+	int *offsets;	   // node_count + 1 entries
+	int *targets;	   // edge_count entries
+	int *in_offsets;   // node_count + 1 entries
+	int *sources;	   // edge_count entries
+	char *names;
+	int *name_offsets; // node_count entries
+	int *index;	   // index_capacity slots, -1 for empty
+	int index_capacity;
+	size_t names_size;
+	void *mapping;	   // Mapped snapshot holding the arrays, or NULL
+	size_t mapping_size;
+};
+
+#define SNAPSHOT_MAGIC "OU4GRAPH"
+#define SNAPSHOT_VERSION 2
+#define SNAPSHOT_BYTE_ORDER 0x01020304u
+
+// The checksum of the arrays is FNV-1a over their ints (and the bytes
+// of the names). Each step is one-to-one for a given hash, so a single
+// changed entry always changes the checksum.
+#define CHECKSUM_BASIS 14695981039346656037ULL
+#define CHECKSUM_PRIME 1099511628211ULL
+
+/*
+ * Start of a snapshot file. byte_order and int_size tell if the file
+ * was written on a machine with the same layout of ints.
+ * payload_checksum is the checksum of the arrays computed by
+ * snapshot_scan(), and checksum is name_hash() of the header with
+ * checksum set to 0.
+ */
+struct snapshot_header
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t byte_order;
+	uint32_t int_size;
+	int32_t node_count;
+	int32_t edge_count;
+	int32_t index_capacity;
+	uint64_t names_size;
+	uint64_t payload_checksum;
+	uint64_t checksum;
+};
+
+// =================== INTERNAL FUNCTIONS ======================
+
+/**
+ * index_find_slot() - Find the index slot for a name.
+ * @c: Frozen graph with the index.
+ * @s: Node name.
+ * @hash: Hash value of s.
+ *
+ * Returns: The slot holding the id of the node named s, or the empty
+ * slot where it would be inserted.
+ */
+static int index_find_slot(const csr_graph *c, const char *s, unsigned long hash)
+{
+	int mask = c->index_capacity - 1;
+	int slot = (int)(hash & (unsigned long)mask);
+
+	while (c->index[slot] != -1 && strcmp(c->names + c->name_offsets[c->index[slot]], s) != 0)
+	{
+		slot = (slot + 1) & mask;
+	}
+
+	return slot;
+}
+
+/**
+ * build_predecessors() - Build the predecessor spans of a frozen graph.
+ * @c: Frozen graph with the neighbour spans filled in.
+ *
+ * Transposes the neighbour spans with a counting sort, so the
+ * predecessors of every node come in increasing id order.
+ *
+ * Returns: Nothing.
+ */
+static void build_predecessors(csr_graph *c)
+{
+	c->in_offsets = calloc(c->node_count + 1, sizeof(int));
+	c->sources = malloc((c->edge_count > 0 ? c->edge_count : 1) * sizeof(int));
+
+	for (int e = 0; e < c->edge_count; e++)
+	{
+		c->in_offsets[c->targets[e] + 1]++;
+	}
+	for (int id = 0; id < c->node_count; id++)
+	{
+		c->in_offsets[id + 1] += c->in_offsets[id];
+	}
+
+	int *fill = malloc((c->node_count > 0 ? c->node_count : 1) * sizeof(int));
+	for (int id = 0; id < c->node_count; id++)
+	{
+		fill[id] = c->in_offsets[id];
+	}
+	for (int id = 0; id < c->node_count; id++)
+	{
+		for (int e = c->offsets[id]; e < c->offsets[id + 1]; e++)
+		{
+			c->sources[fill[c->targets[e]]++] = id;
+		}
+	}
+	free(fill);
+}
+
+/**
+ * build_index() - Build the name index of a frozen graph.
+ * @c: Frozen graph with names filled in.
+ *
+ * Returns: Nothing.
+ */
+static void build_index(csr_graph *c)
+{
+	c->index_capacity = 2;
+	while (c->index_capacity < 2 * c->node_count)
+	{
+		c->index_capacity *= 2;
+	}
+
+	c->index = malloc(c->index_capacity * sizeof(int));
+	for (int i = 0; i < c->index_capacity; i++)
+	{
+		c->index[i] = -1;
+	}
+
+	for (int id = 0; id < c->node_count; id++)
+	{
+		const char *s = c->names + c->name_offsets[id];
+		c->index[index_find_slot(c, s, name_hash(s, strlen(s)))] = id;
+	}
+}
+
+/**
+ * header_checksum() - Compute the checksum of a snapshot header.
+ * @h: Header to check.
+ *
+ * Returns: name_hash() of the header with checksum set to 0.
+ */
+static uint64_t header_checksum(const struct snapshot_header *h)
+{
+	struct snapshot_header copy = *h;
+	copy.checksum = 0;
+
+	return name_hash((const char *)&copy, sizeof(copy));
+}
+
+/**
+ * snapshot_sections() - Return the sizes of the arrays of a snapshot.
+ * @c: Frozen graph with node_count, edge_count, index_capacity and
+ *     names_size set.
+ * @sizes: Set to the size in bytes of each of the arrays, in the order
+ *	   they are stored.
+ *
+ * Returns: Nothing.
+ */
+static void snapshot_sections(const csr_graph *c, size_t sizes[7])
+{
+	sizes[0] = (c->node_count + 1) * sizeof(int);	// offsets
+	sizes[1] = c->edge_count * sizeof(int);		// targets
+	sizes[2] = (c->node_count + 1) * sizeof(int);	// in_offsets
+	sizes[3] = c->edge_count * sizeof(int);		// sources
+	sizes[4] = c->node_count * sizeof(int);		// name_offsets
+	sizes[5] = c->index_capacity * sizeof(int);	// index
+	sizes[6] = c->names_size;			// names
+}
+
+/**
+ * padded() - Round a size up to a multiple of 8 bytes.
+ * @size: Size to round.
+ *
+ * Returns: The rounded size.
+ */
+static size_t padded(size_t size)
+{
+	return (size + 7) & ~(size_t)7;
+}
+
+/**
+ * checksum_step() - Add an entry to a checksum.
+ * @sum: Checksum so far.
+ * @value: Entry to add.
+ *
+ * Returns: The new checksum.
+ */
+static inline uint64_t checksum_step(uint64_t sum, uint32_t value)
+{
+	return (sum ^ value) * CHECKSUM_PRIME;
+}
+
+/**
+ * spans_scan() - Check the spans of a snapshot and add them to the
+ * checksum.
+ * @offsets: Span offsets, count + 1 entries.
+ * @ids: Node ids the spans point into, offsets[count] entries.
+ * @count: Number of nodes.
+ * @sum: Checksum, the offsets and ids are added to it.
+ *
+ * Returns: true if the offsets start at 0 and never decrease, and
+ * every id is a node, false otherwise.
+ */
+static bool spans_scan(const int *offsets, const int *ids, int count, uint64_t *sum)
+{
+	uint64_t h = checksum_step(*sum, offsets[0]);
+
+	if (offsets[0] != 0)
+	{
+		return false;
+	}
+	for (int id = 0; id < count; id++)
+	{
+		if (offsets[id + 1] < offsets[id])
+		{
+			return false;
+		}
+		h = checksum_step(h, offsets[id + 1]);
+	}
+	for (int e = 0; e < offsets[count]; e++)
+	{
+		if (ids[e] < 0 || ids[e] >= count)
+		{
+			return false;
+		}
+		h = checksum_step(h, ids[e]);
+	}
+
+	*sum = h;
+	return true;
+}
+
+/**
+ * snapshot_scan() - Check the arrays of a snapshot and compute their
+ * checksum.
+ * @c: Frozen graph, with the ends of the spans already checked.
+ * @sum: Set to the checksum of the arrays, in the order they are
+ *	 stored.
+ *
+ * Reads every array once. The checks are those needed for the frozen
+ * graph to be used without reading outside its arrays or looping
+ * forever in the index. The arrays of a graph made by graph_freeze()
+ * always pass them.
+ *
+ * Returns: true if the arrays are consistent, false otherwise.
+ */
+static bool snapshot_scan(const csr_graph *c, uint64_t *sum)
+{
+	*sum = CHECKSUM_BASIS;
+	if (!spans_scan(c->offsets, c->targets, c->node_count, sum) ||
+	    !spans_scan(c->in_offsets, c->sources, c->node_count, sum))
+	{
+		return false;
+	}
+
+	uint64_t h = *sum;
+	for (int id = 0; id < c->node_count; id++)
+	{
+		if (c->name_offsets[id] < 0 || (size_t)c->name_offsets[id] >= c->names_size)
+		{
+			return false;
+		}
+		h = checksum_step(h, c->name_offsets[id]);
+	}
+
+	// Every node must be in the index once, leaving empty slots
+	int used = 0;
+	for (int slot = 0; slot < c->index_capacity; slot++)
+	{
+		if (c->index[slot] < -1 || c->index[slot] >= c->node_count)
+		{
+			return false;
+		}
+		used += c->index[slot] != -1;
+		h = checksum_step(h, c->index[slot]);
+	}
+
+	for (size_t i = 0; i < c->names_size; i++)
+	{
+		h = checksum_step(h, (unsigned char)c->names[i]);
+	}
+
+	*sum = h;
+	return used == c->node_count;
+}
+
+/**
+ * snapshot_open() - Open a snapshot file as a frozen graph.
+ * @path: Name of the snapshot file.
+ * @check: If true, check the arrays and their checksum with
+ *	   snapshot_scan().
+ *
+ * Returns: A pointer to the frozen graph, or NULL if the file could
+ * not be read or is not a valid snapshot.
+ */
+static csr_graph *snapshot_open(const char *path, bool check)
+{
+	int fd = open(path, O_RDONLY);
+	struct stat st;
+
+	if (fd < 0 || fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(struct snapshot_header))
+	{
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+		return NULL;
+	}
+
+	size_t size = st.st_size;
+	void *mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED)
+	{
+		return NULL;
+	}
+
+	// Check the header, and that the arrays it describes fill the
+	// rest of the file exactly. names_size is checked against the
+	// file size first, so that the sum of the sizes cannot wrap.
+	const struct snapshot_header *h = mapping;
+	csr_graph *c = calloc(1, sizeof(csr_graph));
+	size_t sizes[7];
+	size_t expected = sizeof(*h);
+	bool ok = memcmp(h->magic, SNAPSHOT_MAGIC, sizeof(h->magic)) == 0 &&
+		  h->version == SNAPSHOT_VERSION &&
+		  h->byte_order == SNAPSHOT_BYTE_ORDER &&
+		  h->int_size == sizeof(int) &&
+		  h->checksum == header_checksum(h) &&
+		  h->node_count >= 0 && h->edge_count >= 0 &&
+		  h->index_capacity > h->node_count &&
+		  (h->index_capacity & (h->index_capacity - 1)) == 0 &&
+		  h->names_size <= size;
+
+	if (ok)
+	{
+		c->node_count = h->node_count;
+		c->edge_count = h->edge_count;
+		c->index_capacity = h->index_capacity;
+		c->names_size = h->names_size;
+		snapshot_sections(c, sizes);
+		for (int i = 0; i < 7; i++)
+		{
+			expected += padded(sizes[i]);
+		}
+		ok = expected == size;
+	}
+
+	if (!ok)
+	{
+		munmap(mapping, size);
+		free(c);
+		return NULL;
+	}
+
+	// The padding after each array is not in the checksum, and must
+	// be zero as csr_graph_save() writes it
+	int **arrays[6] = {&c->offsets, &c->targets, &c->in_offsets, &c->sources,
+			   &c->name_offsets, &c->index};
+	char *p = (char *)mapping + sizeof(*h);
+	for (int i = 0; i < 7; i++)
+	{
+		for (size_t b = sizes[i]; check && b < padded(sizes[i]); b++)
+		{
+			ok = ok && p[b] == 0;
+		}
+		if (i < 6)
+		{
+			*arrays[i] = (int *)p;
+			p += padded(sizes[i]);
+		}
+	}
+	c->names = p;
+	c->mapping = mapping;
+	c->mapping_size = size;
+
+	// The spans and names must end where the file says
+	uint64_t sum;
+	if (!ok || c->offsets[c->node_count] != c->edge_count || c->in_offsets[c->node_count] != c->edge_count ||
+	    (c->names_size > 0 && c->names[c->names_size - 1] != '\0') ||
+	    (check && (!snapshot_scan(c, &sum) || sum != h->payload_checksum)))
+	{
+		csr_graph_kill(c);
+		return NULL;
+	}
+
+	return c;
+}
+
+// =================== CSR GRAPH INTERFACE ======================
+
+/**
+ * graph_freeze() - Make a frozen CSR copy of a graph.
+ * @g: Graph to freeze.
+ *
+ * Node i in the frozen graph is the node with id i in g, and its
+ * neighbours are listed in the same order as graph_neighbours().
+ *
+ * Returns: A pointer to the new frozen graph.
+ */
+csr_graph *graph_freeze(const graph *g)
+{
+	csr_graph *c = calloc(1, sizeof(csr_graph));
+	c->node_count = graph_node_count(g);
+	c->offsets = malloc((c->node_count + 1) * sizeof(int));
+	c->name_offsets = malloc((c->node_count > 0 ? c->node_count : 1) * sizeof(int));
+
+	// First pass: count the neighbours and name lengths to size the
+	// arrays
+	size_t names_size = 0;
+	c->offsets[0] = 0;
+	for (int id = 0; id < c->node_count; id++)
+	{
+		node *n = graph_node_by_id(g, id);
+		dlist *neighbours = graph_neighbours(g, n);
+		int degree = 0;
+
+		for (dlist_pos pos = dlist_first(neighbours); !dlist_is_end(neighbours, pos); pos = dlist_next(neighbours, pos))
+		{
+			degree++;
+		}
+		c->offsets[id + 1] = c->offsets[id] + degree;
+
+		c->name_offsets[id] = (int)names_size;
+		names_size += strlen(graph_node_name(g, n)) + 1;
+	}
+	c->edge_count = c->offsets[c->node_count];
+	c->names_size = names_size;
+
+	// Second pass: fill in the neighbour ids and names
+	c->targets = malloc((c->edge_count > 0 ? c->edge_count : 1) * sizeof(int));
+	c->names = malloc(names_size > 0 ? names_size : 1);
+	for (int id = 0; id < c->node_count; id++)
+	{
+		node *n = graph_node_by_id(g, id);
+		dlist *neighbours = graph_neighbours(g, n);
+		int *target = c->targets + c->offsets[id];
+
+		for (dlist_pos pos = dlist_first(neighbours); !dlist_is_end(neighbours, pos); pos = dlist_next(neighbours, pos))
+		{
+			*target++ = graph_node_id(g, dlist_inspect(neighbours, pos));
+		}
+
+		strcpy(c->names + c->name_offsets[id], graph_node_name(g, n));
+	}
+
+	build_predecessors(c);
+	build_index(c);
+
+	return c;
+}
+
+/**
+ * csr_graph_node_count() - Return the number of nodes.
+ * @c: Frozen graph to inspect.
+ *
+ * Returns: The number of nodes.
+ */
+int csr_graph_node_count(const csr_graph *c)
+{
+	return c->node_count;
+}
+
+/**
+ * csr_graph_edge_count() - Return the number of edges.
+ * @c: Frozen graph to inspect.
+ *
+ * Returns: The number of edges.
+ */
+int csr_graph_edge_count(const csr_graph *c)
+{
+	return c->edge_count;
+}
+
+/**
+ * csr_graph_find() - Find a node by name.
+ * @c: Frozen graph to search.
+ * @s: Node name to look for.
+ *
+ * Returns: The id of the node, or -1 if no node has the name.
+ */
+int csr_graph_find(const csr_graph *c, const char *s)
+{
+	return c->index[index_find_slot(c, s, name_hash(s, strlen(s)))];
+}
+
+/**
+ * csr_graph_name() - Return the name of a node.
+ * @c: Frozen graph to inspect.
+ * @id: Node id.
+ *
+ * Returns: The name of the node, owned by the frozen graph.
+ */
+const char *csr_graph_name(const csr_graph *c, int id)
+{
+	return c->names + c->name_offsets[id];
+}
+
+/**
+ * csr_graph_neighbours() - Return the neighbours of a node.
+ * @c: Frozen graph to inspect.
+ * @id: Node id.
+ * @count: Set to the number of neighbours.
+ *
+ * Returns: A pointer to the ids of the neighbours, *count entries
+ * long. The span is owned by the frozen graph.
+ */
+const int *csr_graph_neighbours(const csr_graph *c, int id, int *count)
+{
+	*count = c->offsets[id + 1] - c->offsets[id];
+	return c->targets + c->offsets[id];
+}
+
+/**
+ * csr_graph_predecessors() - Return the predecessors of a node.
+ * @c: Frozen graph to inspect.
+ * @id: Node id.
+ * @count: Set to the number of predecessors.
+ *
+ * Returns: A pointer to the ids of the predecessors, *count entries
+ * long. The span is owned by the frozen graph.
+ */
+const int *csr_graph_predecessors(const csr_graph *c, int id, int *count)
+{
+	*count = c->in_offsets[id + 1] - c->in_offsets[id];
+	return c->sources + c->in_offsets[id];
+}
+
+/**
+ * csr_graph_kill() - Destroy a frozen graph.
+ * @c: Frozen graph to destroy.
+ *
+ * Returns: Nothing.
+ */
+void csr_graph_kill(csr_graph *c)
+{
+	if (c->mapping != NULL)
+	{
+		// The arrays are in the mapped snapshot
+		munmap(c->mapping, c->mapping_size);
+		free(c);
+		return;
+	}
+
+	free(c->offsets);
+	free(c->targets);
+	free(c->in_offsets);
+	free(c->sources);
+	free(c->names);
+	free(c->name_offsets);
+	free(c->index);
+	free(c);
+}
+
+/**
+ * csr_graph_save() - Write a frozen graph to a snapshot file.
+ * @c: Frozen graph to write.
+ * @path: Name of the snapshot file.
+ *
+ * Returns: true if the snapshot was written, false otherwise.
+ */
+bool csr_graph_save(const csr_graph *c, const char *path)
+{
+	FILE *fp = fopen(path, "wb");
+	if (fp == NULL)
+	{
+		return false;
+	}
+
+	struct snapshot_header h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic));
+	h.version = SNAPSHOT_VERSION;
+	h.byte_order = SNAPSHOT_BYTE_ORDER;
+	h.int_size = sizeof(int);
+	h.node_count = c->node_count;
+	h.edge_count = c->edge_count;
+	h.index_capacity = c->index_capacity;
+	h.names_size = c->names_size;
+	snapshot_scan(c, &h.payload_checksum);
+	h.checksum = header_checksum(&h);
+
+	const void *arrays[7] = {c->offsets, c->targets, c->in_offsets, c->sources,
+				 c->name_offsets, c->index, c->names};
+	size_t sizes[7];
+	snapshot_sections(c, sizes);
+
+	static const char padding[8];
+	bool ok = fwrite(&h, sizeof(h), 1, fp) == 1;
+	for (int i = 0; ok && i < 7; i++)
+	{
+		ok = fwrite(arrays[i], 1, sizes[i], fp) == sizes[i] &&
+		     fwrite(padding, 1, padded(sizes[i]) - sizes[i], fp) == padded(sizes[i]) - sizes[i];
+	}
+
+	if (fclose(fp) != 0)
+	{
+		ok = false;
+	}
+	return ok;
+}
+
+/**
+ * csr_graph_open() - Open a snapshot file as a frozen graph.
+ * @path: Name of the snapshot file.
+ *
+ * Returns: A pointer to the frozen graph, or NULL if the file could
+ * not be read or is not a valid snapshot.
+ */
+csr_graph *csr_graph_open(const char *path)
+{
+	return snapshot_open(path, true);
+}
+
+/**
+ * csr_graph_open_unchecked() - Open a trusted snapshot file.
+ * @path: Name of the snapshot file.
+ *
+ * Returns: A pointer to the frozen graph, or NULL if the file could
+ * not be read or its header is not valid.
+ */
+csr_graph *csr_graph_open_unchecked(const char *path)
+{
+	return snapshot_open(path, false);
+}
@@ -0,0 +1,160 @@
+#ifndef __CSR_GRAPH_H
+#define __CSR_GRAPH_H
+
+#include <stdbool.h>
+#include "graph.h"
+
+/*
+ * Frozen, read-only version of a graph in compressed sparse row (CSR)
+ * form. The nodes are addressed by their dense ids from graph.h and the
+ * neighbours of every node are stored as one contiguous span of ids,
+ * so a traversal only reads plain int arrays. The frozen graph owns
+ * copies of the node names and does not depend on the graph it was
+ * made from, which may be changed or killed afterwards.
+ *
+ * Authors: Adam Pettersson
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first public version.
+ *   2026-10-16: v1.1, predecessor spans.
+ *   2026-10-16: v1.2, snapshot files.
+ *   2026-10-16: v1.3, csr_graph_open() checks the arrays,
+ *               csr_graph_open_unchecked().
+ *   2026-10-16: v1.4, checksum of the arrays of a snapshot.
+ */
+
+// ====================== PUBLIC DATA TYPES ==========================
+
+// Anonymous declaration of csr_graph.
+typedef struct csr_graph csr_graph;
+
+// ==================== CSR GRAPH INTERFACE ==========================
+
+/**
+ * graph_freeze() - Make a frozen CSR copy of a graph.
+ * @g: Graph to freeze.
+ *
+ * Node i in the frozen graph is the node with id i in g, and its
+ * neighbours are listed in the same order as graph_neighbours().
+ *
+ * Returns: A pointer to the new frozen graph.
+ */
+csr_graph *graph_freeze(const graph *g);
+
+/**
+ * csr_graph_node_count() - Return the number of nodes.
+ * @c: Frozen graph to inspect.
+ *
+ * Returns: The number of nodes.
+ */
+int csr_graph_node_count(const csr_graph *c);
+
+/**
+ * csr_graph_edge_count() - Return the number of edges.
+ * @c: Frozen graph to inspect.
+ *
+ * Returns: The number of edges.
+ */
+int csr_graph_edge_count(const csr_graph *c);
+
+/**
+ * csr_graph_find() - Find a node by name.
+ * @c: Frozen graph to search.
+ * @s: Node name to look for.
+ *
+ * Returns: The id of the node, or -1 if no node has the name.
+ */
+int csr_graph_find(const csr_graph *c, const char *s);
+
+/**
+ * csr_graph_name() - Return the name of a node.
+ * @c: Frozen graph to inspect.
+ * @id: Node id.
+ *
+ * Returns: The name of the node, owned by the frozen graph.
+ */
+const char *csr_graph_name(const csr_graph *c, int id);
+
+/**
+ * csr_graph_neighbours() - Return the neighbours of a node.
+ * @c: Frozen graph to inspect.
+ * @id: Node id.
+ * @count: Set to the number of neighbours.
+ *
+ * Returns: A pointer to the ids of the neighbours, *count entries
+ * long. The span is owned by the frozen graph.
+ */
+const int *csr_graph_neighbours(const csr_graph *c, int id, int *count);
+
+/**
+ * csr_graph_predecessors() - Return the predecessors of a node.
+ * @c: Frozen graph to inspect.
+ * @id: Node id.
+ * @count: Set to the number of predecessors.
+ *
+ * A node with several edges to id is listed once per edge.
+ *
+ * Returns: A pointer to the ids of the predecessors, *count entries
+ * long. The span is owned by the frozen graph.
+ */
+const int *csr_graph_predecessors(const csr_graph *c, int id, int *count);
+
+/**
+ * csr_graph_kill() - Destroy a frozen graph.
+ * @c: Frozen graph to destroy.
+ *
+ * Returns: Nothing.
+ */
+void csr_graph_kill(csr_graph *c);
+
+// ======================= SNAPSHOTS ==========================
+//
+// A frozen graph can be written to a snapshot file and opened again
+// without the map file. The snapshot is mapped read-only into memory
+// and used as it is, and processes opening the same snapshot share one
+// copy of it in the page cache. csr_graph_open() reads the snapshot
+// once to check its checksum and that a damaged file cannot make the
+// frozen graph read out of bounds; csr_graph_open_unchecked() skips
+// that, and opens in the same short time whatever the size of the
+// graph. A snapshot can
+// only be opened on a machine with the same byte order and int size as
+// the one that wrote it.
+
+/**
+ * csr_graph_save() - Write a frozen graph to a snapshot file.
+ * @c: Frozen graph to write.
+ * @path: Name of the snapshot file.
+ *
+ * Returns: true if the snapshot was written, false otherwise.
+ */
+bool csr_graph_save(const csr_graph *c, const char *path);
+
+/**
+ * csr_graph_open() - Open a snapshot file as a frozen graph.
+ * @path: Name of the snapshot file.
+ *
+ * The frozen graph is used as any other, and must be destroyed with
+ * csr_graph_kill(), which also unmaps the file. The checksum of the
+ * arrays and every span, node id, name offset and index slot in them
+ * are checked, which takes time linear in the size of the snapshot.
+ *
+ * Returns: A pointer to the frozen graph, or NULL if the file could
+ * not be read or is not a valid snapshot.
+ */
+csr_graph *csr_graph_open(const char *path);
+
+/**
+ * csr_graph_open_unchecked() - Open a trusted snapshot file.
+ * @path: Name of the snapshot file.
+ *
+ * Same as csr_graph_open(), but only the header and the size of the
+ * file are checked, so the time taken does not depend on the size of
+ * the snapshot. Only for files known to be written by
+ * csr_graph_save(); a damaged file gives undefined behaviour.
+ *
+ * Returns: A pointer to the frozen graph, or NULL if the file could
+ * not be read or its header is not valid.
+ */
+csr_graph *csr_graph_open_unchecked(const char *path);
+
+#endif
@@ -12,6 +12,20 @@
  *
  * Version information:
  *   2023-05-18: v1.0, first public version.
+ *   2026-10-16: v1.1, name index for graph_find_node(), implemented
+ *               graph_delete_node().
+ *   2026-10-16: v1.2, dense node ids.
+ *   2026-10-16: v1.3, graph_for_each_neighbour().
+ *   2026-10-16: v1.4, epoch stamped seen status, graph_reset_seen()
+ *               in O(1).
+ *   2026-10-16: v1.5, reverse adjacency lists, node marks,
+ *               implemented graph_delete_edge().
+ *   2026-10-16: v1.6, graph_visit for marks kept outside the graph.
+ *   2026-10-16: v1.7, graph_insert_node_n() and graph_find_node_n()
+ *               for names that are not null-terminated.
+ *   2026-10-16: v1.8, node names interned in a name arena.
+ *   2026-10-16: v1.9, graph_insert_node() leaves the graph unchanged
+ *               if the name is already in it.
  */
 
 #include <stdlib.h>
@@ -22,20 +36,176 @@
 #include "dlist.h"
 #include "graph.h"
 #include "array_1d.h"
+#include "name_hash.h"
 
+/*
+ * The graph keeps a hash index from node name to node so that
+ * graph_find_node() does not have to compare the name against every
+ * node. The index is an open addressing table with linear probing of
+ * index_capacity slots, where index_capacity is a power of two at
+ * least twice max_nodes. It therefore never has to grow, and a probe
+ * always ends at an empty (NULL) slot.
+ *
+ * The seen status is stored as a stamp in each node. A node is seen if
+ * its stamp equals the epoch of the graph, so graph_reset_seen() only
+ * has to step the epoch instead of visiting every node. The epoch is
+ * never 0, which is the stamp of a node that has never been seen.
+ *
+ * The node names are stored in an arena of large blocks owned by the
+ * graph, instead of one malloc() per name. graph_insert_node() never
+ * adds a second node with a name already in the graph, so every name
+ * is stored once and nodes_are_equal() only has to compare the
+ * pointers. The arena is
+ * freed as a whole by graph_kill(), so the name of a deleted node stays
+ * in it until then.
+ */
 struct graph
 {
 	array_1d *nodes; // Eftersom att varje nod har en storlek och ett index
 	int node_amount;
+	node **index;
+	int index_capacity;
+	unsigned int epoch;
+	struct name_block *names; // Name arena, the block being filled first
 };
 
+// Size of the blocks of the name arena. A longer name gets a block of
+// its own.
+#define NAME_BLOCK_SIZE 65536
+
+/*
+ * A block of the name arena, holding used bytes of names in data.
+ */
+struct name_block
+{
+	struct name_block *next;
+	size_t used;
+	size_t size;
+	char data[];
+};
+
+/*
+ * id is the position of the node in the nodes array. The ids of the
+ * nodes in a graph are always 0..node_amount-1.
+ *
+ * incoming_nodes holds the source node of every edge to the node, so
+ * that both the edges from and the edges to a node can be found
+ * without looking at the rest of the graph. A node appears once in
+ * incoming_nodes for each time the node appears in adjacent_nodes of
+ * the source node.
+ */
 struct node
 {
-	char *name;
-	bool seen;
+	int id;
+	const char *name; // Interned in the name arena of the graph
+	unsigned long hash; // Hash value of name, used by the name index
+	unsigned int seen_epoch; // mark is valid if equal to the epoch of the graph
+	int mark;
 	dlist *adjacent_nodes; // Använder dlist, eftersom att vi kan komma att vilja ändra antalet
+	dlist *incoming_nodes;
 };
 
+/*
+ * Marks of the nodes kept outside the graph, indexed by node id. As
+ * for the marks in the nodes, a mark is only valid if its stamp equals
+ * epoch, which is never 0.
+ */
+struct graph_visit
+{
+	unsigned int *stamps;
+	int *marks;
+	int size;
+	unsigned int epoch;
+};
+
+// =================== NAME INDEX ======================
+
+/**
+ * index_home() - Return the first index slot to probe for a hash value.
+ * @g: Graph with the index.
+ * @hash: Hash value of a node name.
+ *
+ * Returns: Slot number.
+ */
+static int index_home(const graph *g, unsigned long hash)
+{
+	return (int)(hash & (unsigned long)(g->index_capacity - 1));
+}
+
+/**
+ * index_find_slot() - Find the index slot holding a node name.
+ * @g: Graph with the index.
+ * @s: Node name, need not be null-terminated.
+ * @len: Length of the node name.
+ * @hash: Hash value of the name.
+ *
+ * Returns: The slot with the node, or the empty slot ending the probe
+ * sequence if no node has the name.
+ */
+static int index_find_slot(const graph *g, const char *s, size_t len, unsigned long hash)
+{
+	int i = index_home(g, hash);
+
+	while (g->index[i] != NULL)
+	{
+		const char *name = g->index[i]->name;
+		if (g->index[i]->hash == hash && strncmp(name, s, len) == 0 && name[len] == '\0')
+		{
+			break;
+		}
+		i = (i + 1) & (g->index_capacity - 1);
+	}
+
+	return i;
+}
+
+/**
+ * index_remove() - Remove a node from the name index.
+ * @g: Graph with the index.
+ * @n: Node to remove. Must be in the index.
+ *
+ * Uses backward shift deletion, so no tombstones are needed.
+ *
+ * Returns: Nothing.
+ */
+static void index_remove(graph *g, const node *n)
+{
+	int mask = g->index_capacity - 1;
+	int i = index_home(g, n->hash);
+
+	// The node itself is looked for, so no names are compared
+	while (g->index[i] != n)
+	{
+		if (g->index[i] == NULL)
+		{
+			return;
+		}
+		i = (i + 1) & mask;
+	}
+	int j = i;
+
+	while (true)
+	{
+		j = (j + 1) & mask;
+		if (g->index[j] == NULL)
+		{
+			break;
+		}
+
+		// The node in j may move back to i unless its home slot is
+		// cyclically in (i, j].
+		int home = index_home(g, g->index[j]->hash);
+		bool home_between = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+		if (!home_between)
+		{
+			g->index[i] = g->index[j];
+			i = j;
+		}
+	}
+
+	g->index[i] = NULL;
+}
+
 /**
  * nodes_are_equal() - Check whether two nodes are equal.
  * @n1: Pointer to node 1.
@@ -46,9 +216,72 @@ struct node
  */
 bool nodes_are_equal(const node *n1, const node *n2)
 {
-	// node names are unique, will therefore compare nodeName of nodes
-	return strcmp(n1->name, n2->name) == 0;
+	// node names are unique and interned, so nodes in the same graph
+	// have the same name exactly when they point to the same copy
+	return n1->name == n2->name;
 }
+
+// =================== NAME ARENA ======================
+
+/**
+ * arena_store() - Store a copy of a name in the name arena.
+ * @g: Graph owning the arena.
+ * @s: Start of the name.
+ * @len: Length of the name, which need not be null-terminated.
+ *
+ * Returns: The null-terminated copy of the name.
+ */
+static const char *arena_store(graph *g, const char *s, size_t len)
+{
+	struct name_block *b = g->names;
+
+	if (b == NULL || b->size - b->used < len + 1)
+	{
+		size_t size = len + 1 > NAME_BLOCK_SIZE ? len + 1 : NAME_BLOCK_SIZE;
+		b = malloc(sizeof(struct name_block) + size);
+		b->used = 0;
+		b->size = size;
+		b->next = g->names;
+		g->names = b;
+	}
+
+	char *name = b->data + b->used;
+	memcpy(name, s, len);
+	name[len] = '\0';
+	b->used += len + 1;
+
+	return name;
+}
+// =================== ADJACENCY LISTS ======================
+
+/**
+ * list_remove_node() - Remove a node from an adjacency list.
+ * @l: List to manipulate.
+ * @n: Node to remove.
+ * @all: If true, remove every occurrence of n, otherwise only the first.
+ *
+ * Returns: Nothing.
+ */
+static void list_remove_node(dlist *l, const node *n, bool all)
+{
+	dlist_pos pos = dlist_first(l);
+	while (!dlist_is_end(l, pos))
+	{
+		if (dlist_inspect(l, pos) == n)
+		{
+			pos = dlist_remove(l, pos);
+			if (!all)
+			{
+				return;
+			}
+		}
+		else
+		{
+			pos = dlist_next(l, pos);
+		}
+	}
+}
+
 // =================== GRAPH STRUCTURE INTERFACE ======================
 
 /**
@@ -63,6 +296,16 @@ graph *graph_empty(int max_nodes)
 	graph *g = malloc(sizeof(*g));
 	g->nodes = array_1d_create(0, max_nodes, NULL);
 	g->node_amount = 0;
+	g->epoch = 1;
+	g->names = NULL;
+
+	// The name index has at least twice as many slots as nodes
+	g->index_capacity = 1;
+	while (g->index_capacity < 2 * (max_nodes + 1))
+	{
+		g->index_capacity *= 2;
+	}
+	g->index = calloc(g->index_capacity, sizeof(node *));
 
 	return g;
 }
@@ -110,40 +353,60 @@ bool graph_has_edges(const graph *g)
  * @s: Node name.
  *
  * Creates a new node with a copy of the given name and puts it into
- * the graph.
+ * the graph. If a node with the name is already in the graph, the graph
+ * is left unchanged, so the name index always finds the one node with
+ * a name.
  *
  * Returns: The modified graph.
  */
 graph *graph_insert_node(graph *g, const char *s)
 {
+	return graph_insert_node_n(g, s, strlen(s));
+}
+
+/**
+ * graph_insert_node_n() - Insert a node named by a slice of a string.
+ * @g: Graph to manipulate.
+ * @s: Start of the node name.
+ * @len: Length of the node name, which need not be null-terminated.
+ *
+ * Returns: The modified graph.
+ */
+graph *graph_insert_node_n(graph *g, const char *s, size_t len)
+{
+	// Do nothing if a node already has the name
+	unsigned long hash = name_hash(s, len);
+	int slot = index_find_slot(g, s, len, hash);
+	if (g->index[slot] != NULL)
+	{
+		return g;
+	}
+
 	// Allocate memory for the new node
 	struct node *new_node = malloc(sizeof(struct node));
 
 	// Set the name of the new node
-	// Allocate memory for the new string
-	new_node->name = malloc(strlen(s) + 1);
-	// Check if memory allocation was successful
-	if (new_node->name == NULL)
-	{
-		// Handle memory allocation failure,by returning or freeing already allocated stuff
-		free(new_node);
-		return NULL;
-	}
-	// Copy the content of the old string into the new memory location
-	strcpy(new_node->name, s);
+	new_node->name = arena_store(g, s, len);
+	new_node->hash = hash;
 
 	// Initialize the adjacent_nodes list for the new node
 	new_node->adjacent_nodes = dlist_empty(NULL);
+	new_node->incoming_nodes = dlist_empty(NULL);
 
 	// Initialize the seen status to false
-	new_node->seen = false;
+	new_node->seen_epoch = 0;
+	new_node->mark = 0;
 
 	// Add the new node to the graph's nodes array
+	new_node->id = g->node_amount;
 	array_1d_set_value(g->nodes, new_node, g->node_amount);
 
 	// Increment the number of nodes in the graph
 	g->node_amount++;
 
+	// Add the new node to the name index
+	g->index[slot] = new_node;
+
 	return g;
 }
 
@@ -156,22 +419,22 @@ graph *graph_insert_node(graph *g, const char *s)
  */
 node *graph_find_node(const graph *g, const char *s)
 {
-	// Go through all nodes in the graph
-	for (int i = 0; i < g->node_amount; i++)
-	{
-		// Get the current node
-		node *current_node = array_1d_inspect_value(g->nodes, i);
-
-		// Compare the current nodesname with the given name
-		if (strcmp(current_node->name, s) == 0)
-		{
-			// If the names match return the current node
-			return current_node;
-		}
-	}
+	return graph_find_node_n(g, s, strlen(s));
+}
 
-	// If no node is found with the given name, return NULL
-	return NULL;
+/**
+ * graph_find_node_n() - Find a node named by a slice of a string.
+ * @g: Graph to inspect.
+ * @s: Start of the node name.
+ * @len: Length of the node name, which need not be null-terminated.
+ *
+ * Returns: A pointer to the found node, or NULL.
+ */
+node *graph_find_node_n(const graph *g, const char *s, size_t len)
+{
+	// Look the name up in the name index. The slot is empty (NULL)
+	// if no node has the given name.
+	return g->index[index_find_slot(g, s, len, name_hash(s, len))];
 }
 
 /**
@@ -183,7 +446,7 @@ node *graph_find_node(const graph *g, const char *s)
  */
 bool graph_node_is_seen(const graph *g, const node *n)
 {
-	return n->seen;
+	return graph_node_mark(g, n) != 0;
 }
 
 /**
@@ -196,33 +459,32 @@ bool graph_node_is_seen(const graph *g, const node *n)
  */
 graph *graph_node_set_seen(graph *g, node *n, bool seen)
 {
-	n->seen = seen;
-	return g;
+	return graph_node_set_mark(g, n, seen ? 1 : 0);
 }
 
 /*
  * graph_reset_seen() - Reset the seen status on all nodes in the graph.
  * @g: Graph to modify.
  *
+ * Steps the epoch of the graph, which makes every stamp out of date.
+ * Only when the epoch wraps around are the stamps of all nodes cleared.
+ *
  * Returns: The modified graph.
  */
 graph *graph_reset_seen(graph *g)
 {
-	// Get the number of nodes in the graph
-	int num_nodes = g->node_amount;
+	g->epoch++;
 
-	// Loop over each node in the graph
-	for (int node_idx = 0; node_idx < num_nodes; ++node_idx)
+	if (g->epoch == 0)
 	{
-		// Check if the node exists in the graph
-		if (array_1d_has_value(g->nodes, node_idx))
+		// The epoch has wrapped around. Old stamps could now match
+		// a new epoch, so clear them all and start over.
+		for (int node_idx = 0; node_idx < g->node_amount; ++node_idx)
 		{
-			// Get the current node
 			node *curr_node = array_1d_inspect_value(g->nodes, node_idx);
-
-			// Reset the 'seen' status of the node
-			curr_node->seen = false;
+			curr_node->seen_epoch = 0;
 		}
+		g->epoch = 1;
 	}
 
 	// Return the modified graph
@@ -247,6 +509,9 @@ graph *graph_insert_edge(graph *g, node *n1, node *n2)
 	// Insert n2 into the adjacent nodes list at the first position
 	dlist_insert(n1->adjacent_nodes, n2, insert_pos);
 
+	// Record the edge in the reverse direction as well
+	dlist_insert(n2->incoming_nodes, n1, dlist_first(n2->incoming_nodes));
+
 	// Return the graph
 	return g;
 }
@@ -260,7 +525,46 @@ graph *graph_insert_edge(graph *g, node *n1, node *n2)
  *
  * NOTE: Undefined if the node is not in the graph.
  */
-graph *graph_delete_node(graph *g, node *n);
+graph *graph_delete_node(graph *g, node *n)
+{
+	// Remove the node from the name index
+	index_remove(g, n);
+
+	// Remove all edges to the node from the lists of its source nodes,
+	// and all edges from the node from the lists of its destinations
+	dlist *l = n->incoming_nodes;
+	for (dlist_pos pos = dlist_first(l); !dlist_is_end(l, pos); pos = dlist_next(l, pos))
+	{
+		node *source = dlist_inspect(l, pos);
+		if (source != n)
+		{
+			list_remove_node(source->adjacent_nodes, n, true);
+		}
+	}
+	l = n->adjacent_nodes;
+	for (dlist_pos pos = dlist_first(l); !dlist_is_end(l, pos); pos = dlist_next(l, pos))
+	{
+		node *destination = dlist_inspect(l, pos);
+		if (destination != n)
+		{
+			list_remove_node(destination->incoming_nodes, n, true);
+		}
+	}
+
+	// Keep the nodes array packed by moving the last node into the hole
+	g->node_amount--;
+	node *last = array_1d_inspect_value(g->nodes, g->node_amount);
+	last->id = n->id;
+	array_1d_set_value(g->nodes, last, n->id);
+	array_1d_set_value(g->nodes, NULL, g->node_amount);
+
+	// Deallocate the node
+	dlist_kill(n->adjacent_nodes);
+	dlist_kill(n->incoming_nodes);
+	free(n);
+
+	return g;
+}
 
 /**
  * graph_delete_edge() - Remove an edge from the graph.
@@ -270,9 +574,18 @@ graph *graph_delete_node(graph *g, node *n);
  *
  * Returns: The modified graph.
  *
+ * If the edge has been inserted more than once, one of the copies is
+ * removed.
+ *
  * NOTE: Undefined if the edge is not in the graph.
  */
-graph *graph_delete_edge(graph *g, node *n1, node *n2);
+graph *graph_delete_edge(graph *g, node *n1, node *n2)
+{
+	list_remove_node(n1->adjacent_nodes, n2, false);
+	list_remove_node(n2->incoming_nodes, n1, false);
+
+	return g;
+}
 
 /**
  * graph_choose_node() - Return an arbitrary node from the graph.
@@ -316,6 +629,212 @@ dlist *graph_neighbours(const graph *g, const node *n)
 	return n->adjacent_nodes;
 }
 
+/**
+ * graph_for_each_neighbour() - Call a function for each neighbour of a node.
+ * @g: Graph to inspect.
+ * @n: Node to visit the neighbours of.
+ * @cb: Function to call for each neighbour.
+ * @data: Pointer passed on to cb.
+ *
+ * Walks the adjacency list of the node directly, so no memory is
+ * allocated.
+ *
+ * Returns: true if cb stopped the iteration, otherwise false.
+ */
+bool graph_for_each_neighbour(const graph *g, const node *n, neighbour_callback *cb, void *data)
+{
+	dlist *l = n->adjacent_nodes;
+
+	for (dlist_pos pos = dlist_first(l); !dlist_is_end(l, pos); pos = dlist_next(l, pos))
+	{
+		if (cb(dlist_inspect(l, pos), data))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * graph_for_each_predecessor() - Call a function for each predecessor of a node.
+ * @g: Graph to inspect.
+ * @n: Node to visit the predecessors of.
+ * @cb: Function to call for each predecessor.
+ * @data: Pointer passed on to cb.
+ *
+ * Walks the reverse adjacency list of the node directly, so no memory
+ * is allocated.
+ *
+ * Returns: true if cb stopped the iteration, otherwise false.
+ */
+bool graph_for_each_predecessor(const graph *g, const node *n, neighbour_callback *cb, void *data)
+{
+	dlist *l = n->incoming_nodes;
+
+	for (dlist_pos pos = dlist_first(l); !dlist_is_end(l, pos); pos = dlist_next(l, pos))
+	{
+		if (cb(dlist_inspect(l, pos), data))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * graph_node_mark() - Return the mark of a node.
+ * @g: Graph storing the node.
+ * @n: Node in the graph.
+ *
+ * Returns: The mark set since the last graph_reset_seen(), or 0.
+ */
+int graph_node_mark(const graph *g, const node *n)
+{
+	return n->seen_epoch == g->epoch ? n->mark : 0;
+}
+
+/**
+ * graph_node_set_mark() - Set the mark of a node.
+ * @g: Graph storing the node.
+ * @n: Node in the graph.
+ * @mark: Mark to set.
+ *
+ * Returns: The modified graph.
+ */
+graph *graph_node_set_mark(graph *g, node *n, int mark)
+{
+	n->seen_epoch = g->epoch;
+	n->mark = mark;
+	return g;
+}
+
+/**
+ * graph_visit_empty() - Create visit state for a graph.
+ * @g: Graph to create the state for.
+ *
+ * Returns: A pointer to the new visit state.
+ */
+graph_visit *graph_visit_empty(const graph *g)
+{
+	graph_visit *v = malloc(sizeof(graph_visit));
+	v->size = g->node_amount;
+	v->stamps = calloc(v->size > 0 ? v->size : 1, sizeof(unsigned int));
+	v->marks = malloc((v->size > 0 ? v->size : 1) * sizeof(int));
+	v->epoch = 1;
+
+	return v;
+}
+
+/**
+ * graph_visit_mark() - Return the mark of a node.
+ * @v: Visit state.
+ * @n: Node in the graph.
+ *
+ * Returns: The mark set since the last graph_visit_reset(), or 0.
+ */
+int graph_visit_mark(const graph_visit *v, const node *n)
+{
+	return v->stamps[n->id] == v->epoch ? v->marks[n->id] : 0;
+}
+
+/**
+ * graph_visit_set_mark() - Set the mark of a node.
+ * @v: Visit state.
+ * @n: Node in the graph.
+ * @mark: Mark to set.
+ *
+ * Returns: Nothing.
+ */
+void graph_visit_set_mark(graph_visit *v, const node *n, int mark)
+{
+	v->stamps[n->id] = v->epoch;
+	v->marks[n->id] = mark;
+}
+
+/**
+ * graph_visit_reset() - Reset the marks of all nodes to 0.
+ * @v: Visit state.
+ *
+ * Steps the epoch, and clears the stamps only when it wraps around.
+ *
+ * Returns: Nothing.
+ */
+void graph_visit_reset(graph_visit *v)
+{
+	v->epoch++;
+
+	if (v->epoch == 0)
+	{
+		for (int i = 0; i < v->size; i++)
+		{
+			v->stamps[i] = 0;
+		}
+		v->epoch = 1;
+	}
+}
+
+/**
+ * graph_visit_kill() - Destroy visit state.
+ * @v: Visit state to destroy.
+ *
+ * Returns: Nothing.
+ */
+void graph_visit_kill(graph_visit *v)
+{
+	free(v->stamps);
+	free(v->marks);
+	free(v);
+}
+
+/**
+ * graph_node_count() - Return the number of nodes in the graph.
+ * @g: Graph to inspect.
+ *
+ * Returns: The number of nodes.
+ */
+int graph_node_count(const graph *g)
+{
+	return g->node_amount;
+}
+
+/**
+ * graph_node_id() - Return the id of a node.
+ * @g: Graph storing the node.
+ * @n: Node in the graph.
+ *
+ * Returns: The id of the node, in 0..graph_node_count()-1.
+ */
+int graph_node_id(const graph *g, const node *n)
+{
+	return n->id;
+}
+
+/**
+ * graph_node_by_id() - Return the node with a given id.
+ * @g: Graph to inspect.
+ * @id: Node id, in 0..graph_node_count()-1.
+ *
+ * Returns: A pointer to the node.
+ */
+node *graph_node_by_id(const graph *g, int id)
+{
+	return array_1d_inspect_value(g->nodes, id);
+}
+
+/**
+ * graph_node_name() - Return the name of a node.
+ * @g: Graph storing the node.
+ * @n: Node in the graph.
+ *
+ * Returns: The name of the node, owned by the graph.
+ */
+const char *graph_node_name(const graph *g, const node *n)
+{
+	return n->name;
+}
+
 /**
  * graph_kill() - Destroy a given graph.
  * @g: Graph to destroy.
@@ -345,13 +864,21 @@ void graph_kill(graph *g)
 
 			// Deallocate the neighbours dlist
 			dlist_kill(entry->adjacent_nodes);
+			dlist_kill(entry->incoming_nodes);
 			// Deallocate the node structure.
-			free(entry->name);
 			free(entry);
 		}
 	}
-	// Kill the final parts of the array.
+	// Kill the final parts of the array, the name index and the name
+	// arena.
 	array_1d_kill(g->nodes);
+	free(g->index);
+	while (g->names != NULL)
+	{
+		struct name_block *next = g->names->next;
+		free(g->names);
+		g->names = next;
+	}
 	// same with graph.
 	free(g);
 }
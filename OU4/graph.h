@@ -80,7 +80,8 @@ bool graph_has_edges(const graph *g);
  * @s: Node name.
  *
  * Creates a new node with a copy of the given name and puts it into
- * the graph.
+ * the graph. If a node with the name is already in the graph, the graph
+ * is left unchanged.
  *
  * Returns: The modified graph.
  */
@@ -197,4 +198,206 @@ void graph_kill(graph *g);
  */
 void graph_print(const graph *g);
 
+// =================== NEIGHBOUR ITERATION ======================
+//
+// Local addition to the course interface. Visits the neighbours (or
+// predecessors) of a node in place, without copying any list.
+
+/*
+ * Function called for each neighbour by graph_for_each_neighbour().
+ * @n: The neighbour. Borrowed from the graph.
+ * @data: The data pointer given to graph_for_each_neighbour().
+ *
+ * Returns: true to stop the iteration, false to continue.
+ */
+typedef bool neighbour_callback(node *n, void *data);
+
+/**
+ * graph_for_each_neighbour() - Call a function for each neighbour of a node.
+ * @g: Graph to inspect.
+ * @n: Node to visit the neighbours of.
+ * @cb: Function to call for each neighbour.
+ * @data: Pointer passed on to cb.
+ *
+ * The neighbours are visited in the same order as in the list from
+ * graph_neighbours(). No memory is allocated. The graph must not be
+ * changed by cb, except for the seen status of nodes.
+ *
+ * Returns: true if cb stopped the iteration, otherwise false.
+ */
+bool graph_for_each_neighbour(const graph *g, const node *n, neighbour_callback *cb, void *data);
+
+/**
+ * graph_for_each_predecessor() - Call a function for each predecessor of a node.
+ * @g: Graph to inspect.
+ * @n: Node to visit the predecessors of.
+ * @cb: Function to call for each predecessor.
+ * @data: Pointer passed on to cb.
+ *
+ * A predecessor of n is a node with an edge to n. A node with several
+ * edges to n is visited once per edge. No memory is allocated. The
+ * graph must not be changed by cb, except for the seen status and
+ * marks of nodes.
+ *
+ * Returns: true if cb stopped the iteration, otherwise false.
+ */
+bool graph_for_each_predecessor(const graph *g, const node *n, neighbour_callback *cb, void *data);
+
+// ======================= NODE MARKS ==========================
+//
+// Local addition to the course interface. A mark is a small integer
+// per node, for searches that need more than seen/not seen (e.g. which
+// side of a bidirectional search reached a node). Marks share storage
+// with the seen status: a node is seen if its mark is not 0,
+// graph_node_set_seen() sets the mark to 1 or 0, and
+// graph_reset_seen() resets all marks to 0 in O(1).
+
+/**
+ * graph_node_mark() - Return the mark of a node.
+ * @g: Graph storing the node.
+ * @n: Node in the graph.
+ *
+ * Returns: The mark set since the last graph_reset_seen(), or 0.
+ */
+int graph_node_mark(const graph *g, const node *n);
+
+/**
+ * graph_node_set_mark() - Set the mark of a node.
+ * @g: Graph storing the node.
+ * @n: Node in the graph.
+ * @mark: Mark to set.
+ *
+ * Returns: The modified graph.
+ */
+graph *graph_node_set_mark(graph *g, node *n, int mark);
+
+// ======================= VISIT STATE ==========================
+//
+// Local addition to the course interface. A graph_visit holds marks
+// for the nodes of a graph outside the graph itself, in arrays indexed
+// by node id. The graph is only read while a graph_visit is used, so
+// several searches can run on the same graph at once (e.g. one per
+// thread), each with its own graph_visit. Marks work as for
+// graph_node_mark(), and graph_visit_reset() clears all marks in O(1).
+
+// Anonymous declaration of graph_visit.
+typedef struct graph_visit graph_visit;
+
+/**
+ * graph_visit_empty() - Create visit state for a graph.
+ * @g: Graph to create the state for.
+ *
+ * All marks are 0. The state covers the nodes in the graph when it is
+ * created, so nodes must not be inserted or deleted while it is used.
+ *
+ * Returns: A pointer to the new visit state.
+ */
+graph_visit *graph_visit_empty(const graph *g);
+
+/**
+ * graph_visit_mark() - Return the mark of a node.
+ * @v: Visit state.
+ * @n: Node in the graph.
+ *
+ * Returns: The mark set since the last graph_visit_reset(), or 0.
+ */
+int graph_visit_mark(const graph_visit *v, const node *n);
+
+/**
+ * graph_visit_set_mark() - Set the mark of a node.
+ * @v: Visit state.
+ * @n: Node in the graph.
+ * @mark: Mark to set.
+ *
+ * Returns: Nothing.
+ */
+void graph_visit_set_mark(graph_visit *v, const node *n, int mark);
+
+/**
+ * graph_visit_reset() - Reset the marks of all nodes to 0.
+ * @v: Visit state.
+ *
+ * Returns: Nothing.
+ */
+void graph_visit_reset(graph_visit *v);
+
+/**
+ * graph_visit_kill() - Destroy visit state.
+ * @v: Visit state to destroy.
+ *
+ * Returns: Nothing.
+ */
+void graph_visit_kill(graph_visit *v);
+
+// ======================= NODE IDS ==========================
+//
+// Local additions to the course interface. Every node has a dense id
+// in 0..graph_node_count()-1, which can be used to keep per-node data
+// in plain arrays. Deleting a node gives its id to the node that had
+// the highest id.
+
+/**
+ * graph_node_count() - Return the number of nodes in the graph.
+ * @g: Graph to inspect.
+ *
+ * Returns: The number of nodes.
+ */
+int graph_node_count(const graph *g);
+
+/**
+ * graph_node_id() - Return the id of a node.
+ * @g: Graph storing the node.
+ * @n: Node in the graph.
+ *
+ * Returns: The id of the node, in 0..graph_node_count()-1.
+ */
+int graph_node_id(const graph *g, const node *n);
+
+/**
+ * graph_node_by_id() - Return the node with a given id.
+ * @g: Graph to inspect.
+ * @id: Node id, in 0..graph_node_count()-1.
+ *
+ * Returns: A pointer to the node.
+ */
+node *graph_node_by_id(const graph *g, int id);
+
+/**
+ * graph_node_name() - Return the name of a node.
+ * @g: Graph storing the node.
+ * @n: Node in the graph.
+ *
+ * Returns: The name of the node, owned by the graph.
+ */
+const char *graph_node_name(const graph *g, const node *n);
+
+// ======================= NAME SLICES ==========================
+//
+// Local additions to the course interface. The name is given as a
+// pointer and a length instead of a null-terminated string, so that a
+// name can be used where it stands, e.g. in a buffer holding a whole
+// file, without first being copied out.
+
+/**
+ * graph_insert_node_n() - Insert a node named by a slice of a string.
+ * @g: Graph to manipulate.
+ * @s: Start of the node name.
+ * @len: Length of the node name, which need not be null-terminated.
+ *
+ * Works as graph_insert_node() with the first len characters of s.
+ *
+ * Returns: The modified graph.
+ */
+graph *graph_insert_node_n(graph *g, const char *s, size_t len);
+
+/**
+ * graph_find_node_n() - Find a node named by a slice of a string.
+ * @g: Graph to inspect.
+ * @s: Start of the node name.
+ * @len: Length of the node name, which need not be null-terminated.
+ *
+ * Returns: A pointer to the found node, or NULL.
+ */
+node *graph_find_node_n(const graph *g, const char *s, size_t len);
+
 #endif
@@ -6,459 +6,643 @@
  * It then checks if there is a path from the origin node to the destination
  * in the graph and prints the result.
  *
+ * Usage: is_connected [-i] [-m] [-b queryfile] [-t threads]
+ *                     [-w snapshot] [-s | -S] mapfile
+ *
+ * With -i the graph is frozen after loading and a reachability index
+ * of its strongly connected components is built (see reach_index.h).
+ * The queries are then answered from the index instead of by a search
+ * of the graph, which pays off when many queries are made on one map.
+ *
+ * -m also builds the transitive closure of the index as a bit matrix
+ * (see reach_closure.h), so every query is a single bit test. If the
+ * graph has more than MAX_CLOSURE_COMPONENTS components the matrix
+ * would be too large, and the index is used on its own.
+ *
+ * With -b the program does not ask for queries but reads them from
+ * queryfile (- for standard input), one origin/destination pair per
+ * line up to the end of the file or a line starting with quit, and
+ * prints one answer line per query in the same order. Without -i/-m
+ * the queries are grouped by origin, so that a single search from each
+ * origin with many queries answers all of them. -t answers the batch
+ * with several threads, which share the graph and index read-only and
+ * keep their search state apart (see struct query_state).
+ *
+ * -t without -b (and without -i/-m) freezes the graph and answers each
+ * query with a parallel, direction-optimizing BFS over all threads
+ * (see par_bfs.h), for single queries on very large maps. In every
+ * mode, -t also loads a large map with several threads.
+ *
+ * -w writes the loaded graph to a snapshot file (see csr_graph.h), and
+ * -s reads mapfile as such a snapshot instead of as a map. The snapshot
+ * is mapped into memory as it is and only read once to check it, so
+ * the program starts quickly even for a very large map. -S is -s for a
+ * trusted snapshot: only its header is checked, and the program starts
+ * at once whatever the size of the snapshot. With -s or -S there is no
+ * adjacency list graph, so without -i/-m the queries are answered by
+ * par_bfs() on the snapshot.
+ *
  * Authors: Adam Pettersson
  *
  *
  * Version information:
  *   2023-06-02: v2.0
+ *   2026-10-16: v2.1, find_path() visits neighbours without copying
+ *               the neighbour list.
+ *   2026-10-16: v2.2, bidirectional search in find_path().
+ *   2026-10-16: v2.3, -i for answering queries from a reachability
+ *               index.
+ *   2026-10-16: v2.4, -m for answering queries from the transitive
+ *               closure.
+ *   2026-10-16: v2.5, -b for batch queries.
+ *   2026-10-16: v2.6, -t for answering batches with several threads.
+ *   2026-10-16: v2.7, -t for a parallel search per query.
+ *   2026-10-16: v2.8, the map is read in one pass, straight into the
+ *               graph.
+ *   2026-10-16: v2.9, the map is loaded by map_load().
+ *   2026-10-16: v2.10, -w and -s for snapshots.
+ *   2026-10-16: v2.11, -t for loading the map in parallel.
+ *   2026-10-16: v2.12, -b rejects names that are too long instead of
+ *               splitting them.
+ *   2026-10-16: v2.13, -S for trusted snapshots.
+ *   2026-10-16: v2.14, -b reads lines of any length, and reports a
+ *               line with only one name.
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <stdint.h>
 #include "graph.h"
-#include <ctype.h>
-#include "list.h"
 #include "queue.h"
+#include <unistd.h>
+#include <pthread.h>
+#include "csr_graph.h"
+#include "reach_index.h"
+#include "reach_closure.h"
+#include "par_bfs.h"
+#include "map_loader.h"
 
 #define MAX_INPUT_LENGTH 500
 #define MAX_NODE_NAME_LENGTH 40
 #define MAX_NODE_CHAR_LENGTH 41
 
-bool validate_node_names(char *src, char *dest);
-int get_number_of_edges(FILE *fp);
-void add_edges_to_list(FILE *fp, list *l);
-struct graph_edges *create_edge(char *src, char *dest);
-int info_from_file(int argc, char **argv, list *l);
-graph *create_graph(graph *g, list *l);
-bool find_path(graph *g, node *src, node *dest);
-void check_the_input(char *input, char *origin, char *destination, graph *g);
-bool check_for_quit(char *input);
-void find_and_show_path(graph *g, char *origin, char *destination);
-void freefunc(void *data_to_free);
-graph *prepare_graph(int argc, char **argv, list *l);
-
-// adam@adam-VirtualBox:~/edu/doa/OU4$ gcc -I/home/adam/edu/doa/OU4 -o connected is_connected.c graph.c list.c queue.c dlist.c array_1d.c
-
-// Verkar som att input med en nod strular? testa med filen badmap?  
-// Vad är det i resultatet som inte stämmer överens med vad som förväntas i 3-directed graph? 
+// Marks used by the two sides of the search in find_path()
+#define FORWARD 1
+#define BACKWARD 2
 
-struct graph_edges
-{
-	char src[MAX_NODE_CHAR_LENGTH];
-	char dest[MAX_NODE_CHAR_LENGTH];
-};
-
-/**
- * main() = The main function of the program.
- * @argc: Number of command arguments.
- * @argv: Array of command arguments.
- *
- * Returns: 0 if everything works out.
- */
-
-int main(int argc, char **argv)
-{
-	// Initialize an empty list
-	list *l = list_empty(freefunc);
+// Largest number of components for -m, giving a matrix of 128 MiB
+#define MAX_CLOSURE_COMPONENTS 32768
 
-	// Prepare the graph using the file inputs and the list
-	graph *g = prepare_graph(argc, argv, l);
+// Marks used by the search from one origin in batch mode
+#define REACHED 1
+#define TARGET 2
 
-	// Initialize input, origin and destination strings
-	char input[MAX_INPUT_LENGTH];
-	char origin[MAX_NODE_CHAR_LENGTH], destination[MAX_NODE_CHAR_LENGTH];
+// Characters separating the names on a line in batch mode, the same
+// as for %s in scanf()
+#define NAME_SEPARATORS " \t\n\v\f\r"
 
-	// Keep checking for user input until a quit signal is received
-	while (1)
-	{
-		check_the_input(input, origin, destination, g);
+// Smallest number of queries with the same origin in batch mode that
+// are answered by one search from the origin. Smaller groups are
+// answered one query at a time by find_path(), whose bidirectional
+// search usually stops long before a full search from the origin would.
+#define BATCH_GROUP_MIN 8
 
-		if (check_for_quit(input))
+// Number of queries handed to a thread at a time in batch mode with
+// an index
+#define BATCH_CHUNK 256
 
-			break;
+// Size of the output buffer in batch mode
+#define BATCH_OUTPUT_BUFFER (1 << 16)
 
-		find_and_show_path(g, origin, destination);
-	}
+/*
+ * What the queries are answered from. g is built from the map file,
+ * and is NULL with -s. frozen is built with -i, -m, -t or -w, or opened
+ * from the snapshot with -s. index is only built with -i or -m, and
+ * closure only with -m. The queries are answered from the first of
+ * closure and index that has been built, otherwise by par_bfs() on
+ * frozen if there is no g or search_threads is above 1, otherwise by
+ * find_path() on g.
+ */
+struct path_finder
+{
+	graph *g;
+	csr_graph *frozen;
+	reach_index *index;
+	reach_closure *closure;
+	int search_threads;
+};
 
-	// Free up the memory allocated to the graph
-	graph_kill(g);
+/*
+ * Why a query in batch mode is not answered.
+ */
+enum batch_error
+{
+	BATCH_OK,
+	BATCH_ONE_NAME,		   // Only an origin on the line
+	BATCH_ORIGIN_TOO_LONG,	   // Longer than MAP_MAX_NAME_LENGTH
+	BATCH_DESTINATION_TOO_LONG // Longer than MAP_MAX_NAME_LENGTH
+};
 
-	return 0;
-}
+/*
+ * One query in batch mode. src and dest are the node ids, or -1 if
+ * there is no node with the name or the query has an error. For a
+ * name that is too long, name_length is its length.
+ */
+struct batch_query
+{
+	char origin[MAX_NODE_CHAR_LENGTH];
+	char destination[MAX_NODE_CHAR_LENGTH];
+	int src;
+	int dest;
+	bool found;
+	enum batch_error error;
+	int name_length;
+};
 
-/**
- * prepare_graph() - Prepares the graph, reads info from the file and
- * creates the graph based on the infoo.
- *
- * @argc: Number of command line arguments.
- * @argv: Array of command line arguments.
- * @l: Pointer to the list.
+/*
+ * Search state for answering queries. Each thread that answers
+ * queries has its own, so the graph and the index are only read and
+ * several queries can be answered at once.
  *
- * Returns: Pointer to the created graph.
+ * fifo, head, tail and pending are used by the search from one origin
+ * in batch mode. pending is the number of destinations marked TARGET
+ * that have not been reached. Every node is enqueued at most once per
+ * search (the origin at most twice), so the queue is a plain array with
+ * room for all nodes plus one. Without g, the search from one origin is
+ * done by par_bfs() instead, which fills in the bitmap reached.
  */
-graph *prepare_graph(int argc, char **argv, list *l)
+struct query_state
 {
-	// Get info from file and get the amount of edges
-	int edges_amount = info_from_file(argc, argv, l);
+	graph_visit *visit; // NULL without g
+	reach_visit *reach; // NULL without an index
+	uint64_t *reached;  // NULL with g
+	node **fifo;
+	int head;
+	int tail;
+	int pending;
+};
 
-	// Build an empty graph with the amount of edges
-	graph *g = graph_empty(edges_amount);
+/*
+ * A batch of queries shared by the threads answering it. The queries
+ * in order[groups[i]..groups[i+1]-1] form group i, and are answered by
+ * the same thread. The threads take the groups in turn, next_group is
+ * the first group not yet taken and is protected by lock.
+ */
+struct batch
+{
+	struct path_finder *pf;
+	struct batch_query *queries;
+	int *order;
+	int *groups;
+	int group_count;
+	int next_group;
+	pthread_mutex_t lock;
+};
 
-	// Build the graph from the list
-	g = create_graph(g, l);
+/*
+ * A thread answering queries of a batch.
+ */
+struct worker
+{
+	pthread_t thread;
+	struct batch *batch;
+	struct query_state state;
+};
 
-	// Free up the memory
-	list_kill(l);
+bool find_path(graph *g, graph_visit *visit, node *src, node *dest);
+void query_state_init(struct query_state *state, const struct path_finder *pf);
+void query_state_free(struct query_state *state);
+int find_node_id(const struct path_finder *pf, const char *name);
+bool path_exists(const struct path_finder *pf, struct query_state *state, int src, int dest);
+void check_the_input(char *input, char *origin, char *destination, const struct path_finder *pf);
+bool check_for_quit(char *input);
+void find_and_show_path(const struct path_finder *pf, struct query_state *state, char *origin, char *destination);
+graph *prepare_graph(const char *path, int threads);
+struct batch_query *read_batch(FILE *fp, int *count, const struct path_finder *pf);
+int compare_by_origin(const void *a, const void *b);
+bool reach_node(node *n, void *data);
+void answer_from_origin(const struct path_finder *pf, struct query_state *state, struct batch_query *queries, const int *order, int count);
+void *answer_groups(void *data);
+void run_batch(struct path_finder *pf, const char *path, int threads);
 
-	return g;
-}
+// adam@adam-VirtualBox:~/edu/doa/OU4$ gcc -I/home/adam/edu/doa/OU4 -o connected is_connected.c graph.c list.c queue.c dlist.c array_1d.c
+// With the index and threads: gcc -I/home/adam/edu/doa/OU4 -o connected is_connected.c graph.c csr_graph.c reach_index.c reach_closure.c par_bfs.c map_loader.c queue.c dlist.c array_1d.c -lpthread
+
+// Verkar som att input med en nod strular? testa med filen badmap?  
+// Vad är det i resultatet som inte stämmer överens med vad som förväntas i 3-directed graph? 
 
 /**
- * info_from_file() - Get information from a file and populate the list.
- * @argc: Number of command line arguments.
- * @argv: Array of command line arguments.
- * @l: Pointer to the list.
+ * main() = The main function of the program.
+ * @argc: Number of command arguments.
+ * @argv: Array of command arguments.
  *
- * Returns: The number of edges found in the file.
+ * Returns: 0 if everything works out.
  */
-int info_from_file(int argc, char **argv, list *l)
+
+int main(int argc, char **argv)
 {
+	bool use_index = false;
+	bool use_closure = false;
+	const char *batch_path = NULL;
+	const char *snapshot_path = NULL;
+	bool from_snapshot = false;
+	bool trusted_snapshot = false;
+	int threads = 1;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "imb:t:w:sS")) != -1)
+	{
+		switch (opt)
+		{
+		case 'i':
+			use_index = true;
+			break;
+		case 'm':
+			use_index = true;
+			use_closure = true;
+			break;
+		case 'b':
+			batch_path = optarg;
+			break;
+		case 't':
+			threads = atoi(optarg);
+			if (threads < 1)
+			{
+				threads = 1;
+			}
+			break;
+		case 'w':
+			snapshot_path = optarg;
+			break;
+		case 's':
+			from_snapshot = true;
+			break;
+		case 'S':
+			from_snapshot = true;
+			trusted_snapshot = true;
+			break;
+		default:
+			fprintf(stderr, "Usage: %s [-i] [-m] [-b queryfile] [-t threads] [-w snapshot] [-s | -S] mapfile\n", argv[0]);
+			exit(EXIT_FAILURE);
+		}
+	}
 
 	// Check if we have a file as input
-	if (argc < 2)
+	if (optind >= argc)
 	{
 		printf("No file as input\n");
 		exit(EXIT_FAILURE);
 	}
 
-	// Open file
-	FILE *fp = fopen(argv[1], "r");
-	if (!fp)
+	// Prepare the graph from the map file, or open the snapshot
+	struct path_finder pf = {NULL, NULL, NULL, NULL, 1};
+	if (from_snapshot)
 	{
-		printf("Error opening file\n");
-		exit(EXIT_FAILURE);
+		pf.frozen = trusted_snapshot ? csr_graph_open_unchecked(argv[optind]) : csr_graph_open(argv[optind]);
+		if (pf.frozen == NULL)
+		{
+			printf("ERROR: %s is not a valid snapshot \n", argv[optind]);
+			exit(EXIT_FAILURE);
+		}
+	}
+	else
+	{
+		pf.g = prepare_graph(argv[optind], threads);
 	}
 
-	// Extract the amount of edges from the file
-	int edges_amount = get_number_of_edges(fp);
-
-	if (edges_amount == 0)
+	if (pf.frozen == NULL && (use_index || snapshot_path != NULL || (batch_path == NULL && threads > 1)))
 	{
-		printf("ERROR: Number of edges was not added \n");
-		fclose(fp);
+		pf.frozen = graph_freeze(pf.g);
+	}
+	if (snapshot_path != NULL && !csr_graph_save(pf.frozen, snapshot_path))
+	{
+		printf("ERROR: Could not write the snapshot %s \n", snapshot_path);
 		exit(EXIT_FAILURE);
 	}
-
-	// Add the edges to the list
-	add_edges_to_list(fp, l);
-
-	// Close the file
-	fclose(fp);
-
-	return edges_amount * 2;
-}
-
-/**
- * get_number_of_edges() - Get the number of edges from a file.
- * @fp: Pointer to the file.
- *
- * Returns: The number of edges found in the file.
- */
-int get_number_of_edges(FILE *fp)
-{
-	char info_from_file[MAX_INPUT_LENGTH];
-
-	// Start the edge count
-	int edgeCount = 0;
-	bool foundEdges = false;
-
-	// Read info from the file via the loop
-	while (fgets(info_from_file, MAX_INPUT_LENGTH, fp) != NULL)
+	if (use_index)
+	{
+		pf.index = reach_index_build(pf.frozen);
+	}
+	else if (batch_path == NULL)
+	{
+		pf.search_threads = threads;
+	}
+	if (use_closure)
 	{
-		if (info_from_file[0] >= '0' && info_from_file[0] <= '9')
+		if (reach_index_component_count(pf.index) <= MAX_CLOSURE_COMPONENTS)
 		{
-			size_t file_size = strlen(info_from_file);
+			pf.closure = reach_closure_build(pf.index);
+		}
+		else
+		{
+			fprintf(stderr, "Too many components for -m, using the index only.\n");
+		}
+	}
 
-			if (info_from_file[file_size - 1] == '\n')
-			{
-				info_from_file[file_size - 1] = '\0';
+	if (batch_path != NULL)
+	{
+		run_batch(&pf, batch_path, threads);
+	}
+	else
+	{
+		// Initialize input, origin and destination strings
+		char input[MAX_INPUT_LENGTH];
+		char origin[MAX_NODE_CHAR_LENGTH], destination[MAX_NODE_CHAR_LENGTH];
+		struct query_state state;
+		query_state_init(&state, &pf);
+
+		// Keep checking for user input until a quit signal is received
+		while (1)
+		{
+			check_the_input(input, origin, destination, &pf);
 
-				edgeCount = strtol(info_from_file, NULL, 10);
+			if (check_for_quit(input))
 
-				foundEdges = true;
 				break;
-			}
+
+			find_and_show_path(&pf, &state, origin, destination);
 		}
+
+		query_state_free(&state);
 	}
 
-	if (foundEdges && edgeCount > 0)
+	// Free up the memory allocated to the graph
+	if (pf.closure != NULL)
 	{
-		return edgeCount * 2;
+		reach_closure_kill(pf.closure);
 	}
-	else
+	if (pf.index != NULL)
 	{
-		return 0;
+		reach_index_kill(pf.index);
 	}
+	if (pf.frozen != NULL)
+	{
+		csr_graph_kill(pf.frozen);
+	}
+	if (pf.g != NULL)
+	{
+		graph_kill(pf.g);
+	}
+
+	return 0;
 }
 
 /**
- * add_edges_to_list() - Add edges from a file to a list.
- * @fp: Pointer to the file.
- * @l: Pointer to the list.
+ * prepare_graph() - Prepares the graph, reads info from the file and
+ * creates the graph based on the infoo.
+ *
+ * @path: Name of the map file.
+ * @threads: Number of threads to load the map with.
+ *
+ * The file is loaded by map_load(), see map_loader.h. Exits the
+ * program if the file is not a valid map.
+ *
+ * Returns: Pointer to the created graph.
  */
-void add_edges_to_list(FILE *fp, list *l)
+graph *prepare_graph(const char *path, int threads)
 {
-	char info_from_file[MAX_INPUT_LENGTH];
+	graph *g = map_load(path, threads);
 
-	list_pos current_position = list_first(l);
-
-	while (fgets(info_from_file, MAX_INPUT_LENGTH, fp) != NULL)
+	if (g == NULL)
 	{
-		if (info_from_file[0] != '#' && info_from_file[0] != '\n') // Check if the line does not start with '#' or '\n'
-		{
-			char src[MAX_NODE_CHAR_LENGTH], dest[MAX_NODE_CHAR_LENGTH];
-
-			sscanf(info_from_file, "%s%s", src, dest);
-
-			if (validate_node_names(src, dest))
-			{
-				current_position = list_insert(l, create_edge(src, dest), current_position);
-			}
-			else
-			{
-				fclose(fp);
-				exit(EXIT_FAILURE);
-			}
-		}
+		exit(EXIT_FAILURE);
 	}
+
+	return g;
 }
 
+/*
+ * One side of the bidirectional search in find_path(). The forward
+ * side follows edges from the origin, the backward side follows edges
+ * backwards from the destination. Each side marks the nodes it reaches
+ * with its own bit, so a node with both bits lies on a path.
+ */
+struct search_side
+{
+	graph *g;
+	graph_visit *visit;
+	queue *q;
+	int frontier_size; // Nodes of the current level left in q
+	int next_size;	   // Nodes of the next level in q
+	int mark;	   // FORWARD or BACKWARD
+};
+
 /**
- * create_edge() - Create an edge from source to destination.
- * @src: Source node name.
- * @dest: Destination node name.
+ * visit_node() - Visit a node reached by one side of the search.
+ * @n: The node reached.
+ * @data: The struct search_side that reached the node.
+ *
+ * Called by graph_for_each_neighbour() or graph_for_each_predecessor()
+ * for each node next to a node taken from the queue. If the node has
+ * not been reached by this side before, it is marked and enqueued for
+ * the next level.
  *
- * Returns: Pointer to the created edge.
+ * Returns: true if the other side has already reached the node, i.e.
+ * the two searches meet and there is a path, otherwise false.
  */
-struct graph_edges *create_edge(char *src, char *dest)
+bool visit_node(node *n, void *data)
 {
-	struct graph_edges *edge = malloc(sizeof(struct graph_edges));
+	struct search_side *side = data;
+	int mark = graph_visit_mark(side->visit, n);
 
-	memcpy(edge->src, src, MAX_NODE_CHAR_LENGTH);
-	edge->src[MAX_NODE_CHAR_LENGTH - 1] = '\0';
+	if ((mark & (FORWARD | BACKWARD) & ~side->mark) != 0)
+	{
+		return true;
+	}
 
-	memcpy(edge->dest, dest, MAX_NODE_CHAR_LENGTH);
-	edge->dest[MAX_NODE_CHAR_LENGTH - 1] = '\0';
+	if ((mark & side->mark) == 0)
+	{
+		graph_visit_set_mark(side->visit, n, mark | side->mark);
+		side->q = queue_enqueue(side->q, n);
+		side->next_size++;
+	}
 
-	return edge;
+	return false;
 }
 
 /**
- * validate_node_names() - Validate if source and destination node names are alphanumeric
- * @src: Source node name.
- * @dest: Destination node name.
+ * expand_level() - Expand one BFS level of one side of the search.
+ * @side: Side to expand.
  *
- * Returns: true if both source and destination node names are alphanumeric, false otherwise.
+ * Returns: true if the two searches meet, otherwise false.
  */
-bool validate_node_names(char *src, char *dest)
+bool expand_level(struct search_side *side)
 {
-	// Iterate over characters, checking if they're alphanumeric and counting them
-	int scource_name = 0;
-	int destination_name = 0;
-
-	while (src[scource_name] != '\0')
+	while (side->frontier_size > 0)
 	{
-		if (!isalnum(src[scource_name]))
+		node *n = queue_front(side->q);
+		side->q = queue_dequeue(side->q);
+		side->frontier_size--;
+
+		bool met;
+		if (side->mark == FORWARD)
 		{
-			printf("ERROR: Node name for source %s ", src);
-			printf("is not alphanumeric. \n");
-			return false;
+			met = graph_for_each_neighbour(side->g, n, visit_node, side);
 		}
-		scource_name++;
-	}
-
-	while (dest[destination_name] != '\0')
-	{
-		if (!isalnum(dest[destination_name]))
+		else
 		{
-			printf("ERROR: Node name for destination %s ", dest);
-			printf("is not alphanumeric. \n");
-			return false;
+			met = graph_for_each_predecessor(side->g, n, visit_node, side);
+		}
+		if (met)
+		{
+			return true;
 		}
-		destination_name++;
-	}
-
-	// Check if length of node names exceed maximum allowed length
-	if (scource_name > MAX_NODE_NAME_LENGTH)
-	{
-		printf("ERROR: Source node name too long. \n");
-		printf("Max length is 40 characters per node name. \n");
-		printf("Current length of source name: %d characters\n", scource_name);
-		return false;
-	}
-
-	if (destination_name > MAX_NODE_NAME_LENGTH)
-	{
-		printf("ERROR: Destination node name too long. \n");
-		printf("Max length is 40 characters per node name. \n");
-		printf("Current length of destination name: %d characters\n", destination_name);
-		return false;
 	}
 
-	// If all checks passed, return true.
-	return true;
+	// The next level becomes the current one
+	side->frontier_size = side->next_size;
+	side->next_size = 0;
+	return false;
 }
 
 /**
- * create_graph() - Create a graph from the list.
- * @g: Pointer to the graph.
- * @l: Pointer to the list.
+ * find_path() - Finds if there is a path between the source and destination nodes using BFS.
+ * @g: The graph containing the nodes.
+ * @visit: Visit state to keep the marks of the search in.
+ * @src: The source node.
+ * @dest: The destination node.
  *
- * Returns: Pointer to the created graph.
+ * This function uses bidirectional breadth-first search (BFS) to find
+ * if there is a path between the source and destination nodes. One
+ * search goes forward from the source and one goes backward from the
+ * destination, and each step expands a whole level of the side with
+ * the smaller frontier. There is a path as soon as one side follows an
+ * edge to a node the other side has reached. If either side runs out
+ * of nodes, there is no path.
+ *
+ * As before, only paths with at least one edge count, so a node only
+ * has a path to itself if it is on a cycle.
+ *
+ * The graph is only read, the marks are kept in visit.
+ *
+ * Returns: true if a path exists, false otherwise.
  */
-graph *create_graph(graph *g, list *l)
+bool find_path(graph *g, graph_visit *visit, node *src, node *dest)
 {
-	// Loopa igenom alla positioner i listan, från första till sista
-	for (list_pos pos = list_first(l); pos != list_end(l); pos = list_next(l, pos))
+	struct search_side forward = {g, visit, queue_empty(NULL), 1, 0, FORWARD};
+	struct search_side backward = {g, visit, queue_empty(NULL), 1, 0, BACKWARD};
+
+	// Start the two searches. If src and dest are the same node it
+	// gets both marks.
+	graph_visit_set_mark(visit, src, FORWARD);
+	graph_visit_set_mark(visit, dest, graph_visit_mark(visit, dest) | BACKWARD);
+	forward.q = queue_enqueue(forward.q, src);
+	backward.q = queue_enqueue(backward.q, dest);
+
+	bool found = false;
+	while (!found && forward.frontier_size > 0 && backward.frontier_size > 0)
 	{
-		// Inspektera nuvarande position i listan och lagra kanten i 'edge'
-		struct graph_edges *edge = list_inspect(l, pos);
-
-		// Försök hitta noden 'src' i grafen 'g'
-		node *src = graph_find_node(g, edge->src);
-
-		// Om noden 'src' inte finns i grafen, lägg till den
-		if (src == NULL)
+		// Expand the side with the smaller frontier
+		if (forward.frontier_size <= backward.frontier_size)
 		{
-			g = graph_insert_node(g, edge->src);
-			src = graph_find_node(g, edge->src);
+			found = expand_level(&forward);
 		}
-
-		// Försök hitta noden 'dest' i grafen 'g'
-		node *dest = graph_find_node(g, edge->dest);
-
-		// Om noden 'dest' inte finns i grafen, lägg till den
-		if (dest == NULL)
+		else
 		{
-			g = graph_insert_node(g, edge->dest);
-			dest = graph_find_node(g, edge->dest);
+			found = expand_level(&backward);
 		}
-
-		// Lägg till en kant mellan noderna 'src' och 'dest' i grafen
-		g = graph_insert_edge(g, src, dest);
 	}
 
-	// Returnera den uppdaterade grafen
-	return g;
+	queue_kill(forward.q);
+	queue_kill(backward.q);
+	graph_visit_reset(visit);
+	return found;
 }
 
 /**
- * visit_node() - Marks a node as visited and enqueues it in the queue.
- * @g: The graph containing the node.
- * @n: The node to visit.
- * @q: The queue used in the BFS traversal.
- *
- * This function is used in the breadth-first search (BFS) traversal of the graph.
- * It checks if a node has been visited (seen), if not, it marks it as visited
- * and enqueues it in the queue for further processing.
+ * query_state_init() - Set up the search state for answering queries.
+ * @state: State to set up.
+ * @pf: What the queries are answered from.
+ *
+ * Returns: Nothing.
  */
-void visit_node(graph *g, node *n, queue *q)
+void query_state_init(struct query_state *state, const struct path_finder *pf)
 {
-	if (!graph_node_is_seen(g, n))
+	state->visit = NULL;
+	state->reach = pf->index != NULL ? reach_visit_empty(pf->index) : NULL;
+	state->reached = NULL;
+	state->fifo = NULL;
+
+	if (pf->g != NULL)
+	{
+		state->visit = graph_visit_empty(pf->g);
+		state->fifo = malloc((graph_node_count(pf->g) + 1) * sizeof(node *));
+	}
+	else
 	{
-		graph_node_set_seen(g, n, 1);
-		q = queue_enqueue(q, n);
+		state->reached = malloc(((csr_graph_node_count(pf->frozen) + 63) / 64 + 1) * sizeof(uint64_t));
 	}
 }
 
 /**
- * destination_found() - Handles the scenario where the destination node is found.
- * @g: The graph containing the nodes.
- * @q: The queue used in the BFS traversal.
+ * query_state_free() - Free the search state for answering queries.
+ * @state: State to free.
  *
- * This function is called when the destination node has been found in the BFS traversal.
- * It resets all nodes in the graph to "not seen" and frees the memory used by the queue.
- * Returns: true to indicate that the destination has been found.
+ * Returns: Nothing.
  */
-bool destination_found(graph *g, queue *q)
+void query_state_free(struct query_state *state)
 {
-	graph_reset_seen(g);
-	queue_kill(q);
-	return 1;
+	if (state->visit != NULL)
+	{
+		graph_visit_kill(state->visit);
+	}
+	if (state->reach != NULL)
+	{
+		reach_visit_kill(state->reach);
+	}
+	free(state->reached);
+	free(state->fifo);
 }
 
 /**
- * find_path() - Finds if there is a path between the source and destination nodes using BFS.
- * @g: The graph containing the nodes.
- * @src: The source node.
- * @dest: The destination node.
+ * find_node_id() - Look up a node by name.
+ * @pf: What the queries are answered from.
+ * @name: Name of the node.
  *
- * This function uses breadth-first search (BFS) to find if there is a path
- * between the source and destination nodes. It marks the source node as visited,
- * then visits all its neighboring nodes by adding them to a queue.
- * If the destination node is found during this process, it returns true.
- * If the queue is emptied and the destination node has not been found, it returns false.
- * Returns: true if a path exists, false otherwise.
+ * Returns: The id of the node, or -1 if there is no such node.
  */
-bool find_path(graph *g, node *src, node *dest)
+int find_node_id(const struct path_finder *pf, const char *name)
 {
-	// Mark the source node as seen
-	g = graph_node_set_seen(g, src, 1);
-
-	// Create an empty queue and put the source node into it
-	queue *q = queue_empty(NULL);
-	q = queue_enqueue(q, src);
-
-	// Loop while the queue is not empty
-	while (!queue_is_empty(q))
+	if (pf->frozen != NULL)
 	{
-		// Take a node away from the queue and get its neighbors
-		node *newNode = queue_front(q);
-		q = queue_dequeue(q);
-		dlist *neighbourSet = graph_neighbours(g, newNode);
-		dlist *neighbourSetCopy = dlist_empty(NULL);
-		dlist_pos pos = dlist_first(neighbourSet);
-
-		// Create a copy of the neighbourSet
-		while (!dlist_is_end(neighbourSet, pos))
-		{
-			void *element = dlist_inspect(neighbourSet, pos);
-			dlist_insert(neighbourSetCopy, element, dlist_first(neighbourSetCopy));
-			pos = dlist_next(neighbourSet, pos);
-		}
-
-		pos = dlist_first(neighbourSetCopy);
-
-		// Go through each neighbor
-		while (!dlist_is_end(neighbourSetCopy, pos))
-		{
-			node *neighbourNode = dlist_inspect(neighbourSetCopy, pos);
-
-			// If a neighbour is the destination we found the path
-			if (nodes_are_equal(neighbourNode, dest))
-			{
-				// dlist_kill(neighbourSet); // Do not deallocate neighbourSet here
-				dlist_kill(neighbourSetCopy);
-				return destination_found(g, q);
-			}
-
-			// Visit the neighbour, set as seen and remove
-			visit_node(g, neighbourNode, q);
+		return csr_graph_find(pf->frozen, name);
+	}
 
-			// Go to the next neighbour
-			pos = dlist_next(neighbourSetCopy, pos);
-		}
+	node *n = graph_find_node(pf->g, name);
+	return n != NULL ? graph_node_id(pf->g, n) : -1;
+}
 
-		// kill the neighbours list after using it
-		//  dlist_kill(neighbourSet); // Do not deallocate neighbourSet here
-		dlist_kill(neighbourSetCopy);
+/**
+ * path_exists() - Check if there is a path between two nodes.
+ * @pf: What the queries are answered from.
+ * @state: Search state of the calling thread.
+ * @src: Id of the source node.
+ * @dest: Id of the destination node.
+ *
+ * Uses the transitive closure or the reachability index if there is
+ * one, otherwise par_bfs() or find_path().
+ *
+ * Returns: true if a path exists, false otherwise.
+ */
+bool path_exists(const struct path_finder *pf, struct query_state *state, int src, int dest)
+{
+	if (pf->closure != NULL)
+	{
+		return reach_closure_query(pf->closure, src, dest);
+	}
+	if (pf->index != NULL)
+	{
+		return reach_index_query_visit(pf->index, state->reach, src, dest);
+	}
+	if (pf->g == NULL || pf->search_threads > 1)
+	{
+		return par_bfs(pf->frozen, src, dest, pf->search_threads, NULL);
 	}
 
-	// No path found
-	queue_kill(q);
-	graph_reset_seen(g);
-	return false;
+	return find_path(pf->g, state->visit, graph_node_by_id(pf->g, src), graph_node_by_id(pf->g, dest));
 }
 
 /**
@@ -467,12 +651,12 @@ bool find_path(graph *g, node *src, node *dest)
  * @origin: Array to store origin node.
  * @destination: Array to store destination node.
  */
-void check_the_input(char *input, char *origin, char *destination, graph *g)
+void check_the_input(char *input, char *origin, char *destination, const struct path_finder *pf)
 {
-	node *src = NULL;
-	node *dest = NULL;
+	int src = -1;
+	int dest = -1;
 
-	while (src == NULL || dest == NULL)
+	while (src == -1 || dest == -1)
 	{
 		printf("Enter origin and destination (quit to exit): ");
 		fgets(input, MAX_INPUT_LENGTH, stdin);
@@ -492,14 +676,14 @@ void check_the_input(char *input, char *origin, char *destination, graph *g)
 			continue;
 		}
 
-		src = graph_find_node(g, origin);
-		dest = graph_find_node(g, destination);
+		src = find_node_id(pf, origin);
+		dest = find_node_id(pf, destination);
 
-		if (src == NULL || dest == NULL)
+		if (src == -1 || dest == -1)
 		{
 			printf("One or both nodes do not exist. Try again.\n\n");
-			src = NULL;
-			dest = NULL;
+			src = -1;
+			dest = -1;
 		}
 	}
 }
@@ -524,22 +708,23 @@ bool check_for_quit(char *input)
 
 /**
  * find_and_show_path() - Finds if there is a path between the input nodes and displays the result.
- * @g: The graph where the search will be performed.
+ * @pf: What the query is answered from.
+ * @state: Search state.
  * @origin: The name of the source node.
  * @destination: The name of the destination node.
  *
  * This function first checks if the nodes exist in the graph. If they do,
- * it uses the find_path function to check if there's a path between them.
+ * it uses path_exists() to check if there's a path between them.
  * The result is then printed to the user.
  */
-void find_and_show_path(graph *g, char *origin, char *destination)
+void find_and_show_path(const struct path_finder *pf, struct query_state *state, char *origin, char *destination)
 {
 	// Find nodes corresponding to origin and destination in the graph
-	node *scource_node = graph_find_node(g, origin);
-	node *destination_node = graph_find_node(g, destination);
+	int scource_node = find_node_id(pf, origin);
+	int destination_node = find_node_id(pf, destination);
 
 	// If one or both nodes don't exist, print an error message
-	if (scource_node == NULL || destination_node == NULL)
+	if (scource_node == -1 || destination_node == -1)
 	{
 		printf("One or both nodes do not exist. Try again. \n");
 	}
@@ -547,7 +732,7 @@ void find_and_show_path(graph *g, char *origin, char *destination)
 	else
 	{
 		// If nodes exist, find if a path exists between them
-		if (find_path(g, scource_node, destination_node))
+		if (path_exists(pf, state, scource_node, destination_node))
 		{
 			printf("There is a path from %s to %s.\n\n", origin, destination);
 		}
@@ -559,13 +744,378 @@ void find_and_show_path(graph *g, char *origin, char *destination)
 }
 
 /**
- * freefunc() - A helper function for freeing memory used by list elements.
- * @data_to_free: The data to be freed.
+ * read_batch() - Read the queries of a batch.
+ * @fp: File to read from.
+ * @count: Set to the number of queries read.
+ * @pf: What the queries are answered from, used to look up the names.
+ *
+ * Reads one origin/destination pair per line until the end of the
+ * file or a line starting with quit. Empty lines are skipped. The lines
+ * are read whole whatever their length. A line with only one name or
+ * a name longer than MAP_MAX_NAME_LENGTH is kept as a query with an
+ * error, so that it gets an error message in the output.
+ *
+ * Returns: An array of *count queries, to be freed by the caller.
+ */
+struct batch_query *read_batch(FILE *fp, int *count, const struct path_finder *pf)
+{
+	int capacity = 64;
+	struct batch_query *queries = malloc(capacity * sizeof(struct batch_query));
+	char *input = NULL;
+	size_t input_size = 0;
+
+	*count = 0;
+	while (getline(&input, &input_size, fp) != -1 && strncmp(input, "quit", 4) != 0)
+	{
+		// The names are measured where they are in the line, so that
+		// a long name is neither cut nor split in two
+		const char *origin = input + strspn(input, NAME_SEPARATORS);
+		size_t origin_length = strcspn(origin, NAME_SEPARATORS);
+		const char *destination = origin + origin_length + strspn(origin + origin_length, NAME_SEPARATORS);
+		size_t destination_length = strcspn(destination, NAME_SEPARATORS);
+		if (origin_length == 0)
+		{
+			continue;
+		}
+
+		if (*count == capacity)
+		{
+			capacity *= 2;
+			queries = realloc(queries, capacity * sizeof(struct batch_query));
+		}
+
+		struct batch_query *query = &queries[*count];
+		query->src = -1;
+		query->dest = -1;
+		query->found = false;
+		query->error = BATCH_OK;
+		query->name_length = 0;
+		if (origin_length > MAP_MAX_NAME_LENGTH)
+		{
+			query->error = BATCH_ORIGIN_TOO_LONG;
+			query->name_length = origin_length;
+		}
+		else if (destination_length > MAP_MAX_NAME_LENGTH)
+		{
+			query->error = BATCH_DESTINATION_TOO_LONG;
+			query->name_length = destination_length;
+		}
+		else if (destination_length == 0)
+		{
+			query->error = BATCH_ONE_NAME;
+		}
+		else
+		{
+			memcpy(query->origin, origin, origin_length);
+			query->origin[origin_length] = '\0';
+			memcpy(query->destination, destination, destination_length);
+			query->destination[destination_length] = '\0';
+			query->src = find_node_id(pf, query->origin);
+			query->dest = find_node_id(pf, query->destination);
+		}
+		(*count)++;
+	}
+
+	free(input);
+	return queries;
+}
+
+/*
+ * The queries sorted by compare_by_origin(). Set by run_batch() before
+ * calling qsort(), which has no way to pass it to the compare function.
+ */
+static const struct batch_query *sort_queries;
+
+/**
+ * compare_by_origin() - Compare two queries by origin.
+ * @a: Pointer to the index of the first query.
+ * @b: Pointer to the index of the second query.
+ *
+ * Queries with the same origin are ordered by index, so the order is
+ * the same on every platform.
+ *
+ * Returns: Negative, 0 or positive as for strcmp().
+ */
+int compare_by_origin(const void *a, const void *b)
+{
+	int i = *(const int *)a;
+	int j = *(const int *)b;
+
+	if (sort_queries[i].src != sort_queries[j].src)
+	{
+		return sort_queries[i].src < sort_queries[j].src ? -1 : 1;
+	}
+	return i - j;
+}
+
+/**
+ * reach_node() - Visit a node reached by the search from an origin.
+ * @n: The node reached.
+ * @data: The struct query_state of the search.
  *
- * This function is used as the free function when the list is created.
- * It gets called every time an element is removed from the list.
+ * Returns: true if every destination has been reached, which stops the
+ * search, otherwise false.
  */
-void freefunc(void *data_to_free)
+bool reach_node(node *n, void *data)
 {
-	free(data_to_free);
+	struct query_state *search = data;
+	int mark = graph_visit_mark(search->visit, n);
+
+	if ((mark & REACHED) != 0)
+	{
+		return false;
+	}
+
+	graph_visit_set_mark(search->visit, n, mark | REACHED);
+	search->fifo[search->tail++] = n;
+	if ((mark & TARGET) != 0)
+	{
+		search->pending--;
+	}
+	return search->pending == 0;
+}
+
+/**
+ * answer_from_origin() - Answer all queries with the same origin.
+ * @pf: What the queries are answered from.
+ * @state: Search state of the calling thread.
+ * @queries: All queries of the batch.
+ * @order: Indices of the queries to answer, all with the same origin.
+ * @count: Number of queries to answer.
+ *
+ * Marks all destinations, then does a single BFS from the origin that
+ * stops when every destination has been reached. The origin itself is
+ * only marked as reached if the search gets back to it, so that only
+ * paths with at least one edge count. Without g, par_bfs() on a single
+ * thread finds every node reachable from the origin instead.
+ *
+ * Returns: Nothing.
+ */
+void answer_from_origin(const struct path_finder *pf, struct query_state *state, struct batch_query *queries, const int *order, int count)
+{
+	graph *g = pf->g;
+
+	if (g == NULL)
+	{
+		par_bfs(pf->frozen, queries[order[0]].src, -1, 1, state->reached);
+		for (int i = 0; i < count; i++)
+		{
+			int dest = queries[order[i]].dest;
+			queries[order[i]].found = (state->reached[dest / 64] >> (dest % 64)) & 1;
+		}
+		return;
+	}
+
+	state->head = 0;
+	state->tail = 0;
+	state->pending = 0;
+	for (int i = 0; i < count; i++)
+	{
+		node *n = graph_node_by_id(g, queries[order[i]].dest);
+		if (graph_visit_mark(state->visit, n) == 0)
+		{
+			graph_visit_set_mark(state->visit, n, TARGET);
+			state->pending++;
+		}
+	}
+
+	bool done = false;
+	state->fifo[state->tail++] = graph_node_by_id(g, queries[order[0]].src);
+	while (!done && state->head < state->tail)
+	{
+		node *n = state->fifo[state->head++];
+		done = graph_for_each_neighbour(g, n, reach_node, state);
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		node *n = graph_node_by_id(g, queries[order[i]].dest);
+		queries[order[i]].found = (graph_visit_mark(state->visit, n) & REACHED) != 0;
+	}
+
+	graph_visit_reset(state->visit);
+}
+
+/**
+ * answer_groups() - Answer groups of a batch until there are none left.
+ * @data: The struct worker of the calling thread.
+ *
+ * Used as the start function of the threads answering a batch. With an
+ * index every query is answered on its own. Without, a group holds all
+ * queries with one origin, and is answered by answer_from_origin() if
+ * it is large enough.
+ *
+ * Returns: NULL.
+ */
+void *answer_groups(void *data)
+{
+	struct worker *w = data;
+	struct batch *batch = w->batch;
+	const struct path_finder *pf = batch->pf;
+
+	while (1)
+	{
+		pthread_mutex_lock(&batch->lock);
+		int group = batch->next_group++;
+		pthread_mutex_unlock(&batch->lock);
+
+		if (group >= batch->group_count)
+		{
+			break;
+		}
+
+		int first = batch->groups[group];
+		int last = batch->groups[group + 1];
+		if (pf->index == NULL && last - first >= BATCH_GROUP_MIN)
+		{
+			answer_from_origin(pf, &w->state, batch->queries, batch->order + first, last - first);
+			continue;
+		}
+
+		// Too few queries to pay for a full search, or an index
+		// that answers each query directly
+		for (int i = first; i < last; i++)
+		{
+			struct batch_query *query = &batch->queries[batch->order[i]];
+			query->found = path_exists(pf, &w->state, query->src, query->dest);
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * run_batch() - Answer a batch of queries.
+ * @pf: What the queries are answered from.
+ * @path: Name of the query file, or - for standard input.
+ * @threads: Number of threads to answer the queries with.
+ *
+ * Reads all queries, answers them and prints one line per query, in
+ * the order of the file, through a large output buffer.
+ *
+ * Returns: Nothing.
+ */
+void run_batch(struct path_finder *pf, const char *path, int threads)
+{
+	FILE *fp = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+	if (!fp)
+	{
+		printf("Error opening file\n");
+		exit(EXIT_FAILURE);
+	}
+
+	struct batch batch;
+	int count;
+	batch.pf = pf;
+	batch.queries = read_batch(fp, &count, pf);
+	if (fp != stdin)
+	{
+		fclose(fp);
+	}
+
+	// Queries with unknown nodes are left out of the order
+	batch.order = malloc((count > 0 ? count : 1) * sizeof(int));
+	int answerable = 0;
+	for (int i = 0; i < count; i++)
+	{
+		if (batch.queries[i].src != -1 && batch.queries[i].dest != -1)
+		{
+			batch.order[answerable++] = i;
+		}
+	}
+
+	// Split the queries into groups: chunks of BATCH_CHUNK queries
+	// with an index, otherwise one group per origin
+	batch.groups = malloc((answerable + 1) * sizeof(int));
+	batch.group_count = 0;
+	if (pf->index != NULL)
+	{
+		for (int first = 0; first < answerable; first += BATCH_CHUNK)
+		{
+			batch.groups[batch.group_count++] = first;
+		}
+	}
+	else
+	{
+		sort_queries = batch.queries;
+		qsort(batch.order, answerable, sizeof(int), compare_by_origin);
+
+		for (int i = 0; i < answerable; i++)
+		{
+			if (i == 0 || batch.queries[batch.order[i]].src != batch.queries[batch.order[i - 1]].src)
+			{
+				batch.groups[batch.group_count++] = i;
+			}
+		}
+	}
+	batch.groups[batch.group_count] = answerable;
+	batch.next_group = 0;
+	pthread_mutex_init(&batch.lock, NULL);
+
+	// Answer the groups. A single thread is the calling thread.
+	struct worker *workers = malloc(threads * sizeof(struct worker));
+	for (int i = 0; i < threads; i++)
+	{
+		workers[i].batch = &batch;
+		query_state_init(&workers[i].state, pf);
+	}
+	if (threads == 1)
+	{
+		answer_groups(&workers[0]);
+	}
+	else
+	{
+		for (int i = 0; i < threads; i++)
+		{
+			pthread_create(&workers[i].thread, NULL, answer_groups, &workers[i]);
+		}
+		for (int i = 0; i < threads; i++)
+		{
+			pthread_join(workers[i].thread, NULL);
+		}
+	}
+	for (int i = 0; i < threads; i++)
+	{
+		query_state_free(&workers[i].state);
+	}
+	free(workers);
+	pthread_mutex_destroy(&batch.lock);
+
+	// Print the answers through a large buffer. Nothing has been
+	// written to stdout yet, so its buffering can still be changed.
+	setvbuf(stdout, NULL, _IOFBF, BATCH_OUTPUT_BUFFER);
+	for (int i = 0; i < count; i++)
+	{
+		struct batch_query *query = &batch.queries[i];
+
+		if (query->error == BATCH_ONE_NAME)
+		{
+			printf("You need to input both origin and destination nodes.\n");
+		}
+		else if (query->error != BATCH_OK)
+		{
+			// Same message as map_load() gives for a long name
+			bool origin = query->error == BATCH_ORIGIN_TOO_LONG;
+			printf("ERROR: %s node name too long. \n", origin ? "Source" : "Destination");
+			printf("Max length is %d characters per node name. \n", MAP_MAX_NAME_LENGTH);
+			printf("Current length of %s name: %d characters\n", origin ? "source" : "destination", query->name_length);
+		}
+		else if (query->src == -1 || query->dest == -1)
+		{
+			printf("One or both nodes do not exist: %s %s\n", query->origin, query->destination);
+		}
+		else if (query->found)
+		{
+			printf("There is a path from %s to %s.\n", query->origin, query->destination);
+		}
+		else
+		{
+			printf("There is no path from %s to %s.\n", query->origin, query->destination);
+		}
+	}
+	fflush(stdout);
+
+	free(batch.groups);
+	free(batch.order);
+	free(batch.queries);
 }
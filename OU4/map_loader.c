@@ -0,0 +1,823 @@
+/*
+ * Map file loader, see map_loader.h.
+ *
+ * The whole file is mapped read-only and scanned once from start to
+ * end. Every byte is looked up in char_class, and a name is the run of
+ * bytes up to the next blank or newline. The classes of its bytes are
+ * ORed together while the run is scanned, so whether the name is
+ * alphanumeric is known at the end of the run without a test per byte.
+ *
+ * With several threads, the edge section is split into chunks that
+ * start and end at newlines, and loaded in four steps:
+ *
+ *   1. Each thread scans its chunk into an array of name slices, two
+ *      per edge, and stops at the first invalid line.
+ *   2. Each thread interns the names of its chunk into a table split
+ *      into MAP_SHARDS shards, each with its own lock. The entry of a
+ *      name keeps the position of its first appearance in the file.
+ *   3. The names are inserted into the graph in order of their first
+ *      appearance, so the node ids are the same as when the file is
+ *      read by a single thread.
+ *   4. The edges are inserted into the graph chunk by chunk.
+ *
+ * Only steps 1 and 2 run in parallel, since the graph is not safe to
+ * change from several threads. An invalid line is reported only if no
+ * earlier line is invalid, as when the file is read by a single thread.
+ *
+ * Authors: Adam Pettersson
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first public version.
+ *   2026-10-16: v1.1, parallel loading of large maps.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include "graph.h"
+#include "map_loader.h"
+#include "name_hash.h"
+
+// Byte classes. A name ends at a byte with SEPARATOR set, and is
+// alphanumeric if no byte in it has OTHER set.
+#define NAME_CHAR 0
+#define OTHER 1
+#define SEPARATOR 2
+#define NEWLINE 4
+
+// Number of shards of the intern table, a power of two
+#define MAP_SHARDS 64
+
+// Smallest number of bytes of edges per thread when loading in
+// parallel. Smaller maps are loaded faster by a single thread.
+#define MAP_CHUNK_MIN (1 << 20)
+
+static unsigned char char_class[256];
+
+/*
+ * A node name as a slice of the mapped file.
+ */
+struct name_slice
+{
+	const char *s;
+	size_t len;
+	bool alnum;
+};
+
+/*
+ * One end of an edge found by a thread loading in parallel. ref is
+ * the intern table entry of the name, see intern_ref().
+ */
+struct edge_end
+{
+	const char *s;
+	int len;
+	int ref;
+};
+
+/*
+ * An interned name. first is the position of its first appearance,
+ * 2 * edge + 0 for an origin or 1 for a destination.
+ */
+struct intern_entry
+{
+	const char *s;
+	int len;
+	unsigned long hash;
+	long first;
+	node *n;
+};
+
+/*
+ * A shard of the intern table. slots is an open addressing table of
+ * slot_capacity indices into entries, -1 for empty.
+ */
+struct intern_shard
+{
+	pthread_mutex_t lock;
+	struct intern_entry *entries;
+	int count;
+	int capacity;
+	int *slots;
+	int slot_capacity;
+};
+
+/*
+ * A chunk of the edge section, loaded by one thread. ends holds two
+ * entries per edge. first_edge is the number of edges in the chunks
+ * before it.
+ */
+struct chunk
+{
+	pthread_t thread;
+	const char *start;
+	const char *end;
+	struct edge_end *ends;
+	int edge_count;
+	int capacity;
+	const char *error_line; // First invalid line, or NULL
+	long first_edge;
+	struct intern_shard *shards;
+};
+
+// =================== INTERNAL FUNCTIONS ======================
+
+/**
+ * init_char_class() - Fill in the byte class table.
+ *
+ * Returns: Nothing.
+ */
+static void init_char_class(void)
+{
+	for (int c = 0; c < 256; c++)
+	{
+		if (c == '\n')
+		{
+			char_class[c] = SEPARATOR | NEWLINE;
+		}
+		else if (isspace(c))
+		{
+			char_class[c] = SEPARATOR;
+		}
+		else
+		{
+			char_class[c] = isalnum(c) ? NAME_CHAR : OTHER;
+		}
+	}
+}
+
+/**
+ * next_line() - Find the start of the next line.
+ * @p: Position in the current line.
+ * @end: End of the file.
+ *
+ * Returns: The position after the next newline, or end.
+ */
+static const char *next_line(const char *p, const char *end)
+{
+	const char *nl = p < end ? memchr(p, '\n', end - p) : NULL;
+
+	return nl != NULL ? nl + 1 : end;
+}
+
+/**
+ * scan_name() - Scan a name, skipping any blanks before it.
+ * @p: Position to start at.
+ * @end: End of the file.
+ * @name: Set to the scanned name, with len 0 if the line has no more
+ *	  names.
+ *
+ * Returns: The position after the name.
+ */
+static const char *scan_name(const char *p, const char *end, struct name_slice *name)
+{
+	unsigned char cls;
+	unsigned char seen = 0;
+
+	while (p < end && char_class[(unsigned char)*p] == SEPARATOR)
+	{
+		p++;
+	}
+
+	name->s = p;
+	while (p < end && !((cls = char_class[(unsigned char)*p]) & SEPARATOR))
+	{
+		seen |= cls;
+		p++;
+	}
+	name->len = p - name->s;
+	name->alnum = seen == 0;
+
+	return p;
+}
+
+/**
+ * validate_names() - Check that the names of an edge are valid.
+ * @src: Origin name.
+ * @dest: Destination name.
+ *
+ * Prints an error message for the first invalid name.
+ *
+ * Returns: true if both names are alphanumeric and short enough,
+ * false otherwise.
+ */
+static bool validate_names(const struct name_slice *src, const struct name_slice *dest)
+{
+	if (!src->alnum)
+	{
+		printf("ERROR: Node name for source %.*s ", (int)src->len, src->s);
+		printf("is not alphanumeric. \n");
+		return false;
+	}
+
+	if (!dest->alnum)
+	{
+		printf("ERROR: Node name for destination %.*s ", (int)dest->len, dest->s);
+		printf("is not alphanumeric. \n");
+		return false;
+	}
+
+	if (src->len > MAP_MAX_NAME_LENGTH)
+	{
+		printf("ERROR: Source node name too long. \n");
+		printf("Max length is %d characters per node name. \n", MAP_MAX_NAME_LENGTH);
+		printf("Current length of source name: %d characters\n", (int)src->len);
+		return false;
+	}
+
+	if (dest->len > MAP_MAX_NAME_LENGTH)
+	{
+		printf("ERROR: Destination node name too long. \n");
+		printf("Max length is %d characters per node name. \n", MAP_MAX_NAME_LENGTH);
+		printf("Current length of destination name: %d characters\n", (int)dest->len);
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * names_are_valid() - Quick check of the names of an edge.
+ * @src: Origin name.
+ * @dest: Destination name.
+ *
+ * Returns: true if there are two names and both are valid, false
+ * otherwise.
+ */
+static bool names_are_valid(const struct name_slice *src, const struct name_slice *dest)
+{
+	return dest->len > 0 && src->alnum && dest->alnum &&
+	       src->len <= MAP_MAX_NAME_LENGTH && dest->len <= MAP_MAX_NAME_LENGTH;
+}
+
+/**
+ * scan_line() - Scan the names of an edge line.
+ * @line: Start of the line.
+ * @end: End of the file.
+ * @src: Set to the first name of the line.
+ * @dest: Set to the second name of the line.
+ *
+ * Returns: The start of the next line.
+ */
+static const char *scan_line(const char *line, const char *end, struct name_slice *src, struct name_slice *dest)
+{
+	const char *p = scan_name(line, end, src);
+	p = scan_name(p, end, dest);
+
+	// Anything after the names is ignored
+	return next_line(p, end);
+}
+
+/**
+ * report_line() - Print an error message for an invalid edge line.
+ * @line: Start of the line.
+ * @end: End of the file.
+ *
+ * Returns: Nothing.
+ */
+static void report_line(const char *line, const char *end)
+{
+	struct name_slice src, dest;
+	const char *line_end = scan_line(line, end, &src, &dest);
+
+	if (dest.len == 0)
+	{
+		printf("ERROR: Edge line does not have two node names: %.*s", (int)(line_end - line), line);
+	}
+	else
+	{
+		validate_names(&src, &dest);
+	}
+}
+
+/**
+ * report_full() - Print an error message for a map with too many nodes.
+ *
+ * Returns: Nothing.
+ */
+static void report_full(void)
+{
+	printf("ERROR: The map has more edges than the number given in the file. \n");
+}
+
+/**
+ * find_or_insert_node() - Find a node by name, inserting it if needed.
+ * @g: Graph to manipulate.
+ * @name: Node name.
+ * @max_nodes: Number of nodes the graph has room for.
+ *
+ * Returns: A pointer to the node, or NULL if the node is new and the
+ * graph is full.
+ */
+static node *find_or_insert_node(graph *g, const struct name_slice *name, int max_nodes)
+{
+	node *n = graph_find_node_n(g, name->s, name->len);
+
+	if (n == NULL && graph_node_count(g) < max_nodes)
+	{
+		graph_insert_node_n(g, name->s, name->len);
+		n = graph_node_by_id(g, graph_node_count(g) - 1);
+	}
+
+	return n;
+}
+
+/**
+ * read_edge_count() - Find the number of edges in a map.
+ * @p: Start of the file. Set to the start of the line after the
+ *     number of edges.
+ * @end: End of the file.
+ *
+ * Lines before the first line starting with a digit are skipped.
+ *
+ * Returns: The number of edges, or 0 if none is given.
+ */
+static int read_edge_count(const char **p, const char *end)
+{
+	const char *line = *p;
+
+	while (line < end && (*line < '0' || *line > '9'))
+	{
+		line = next_line(line, end);
+	}
+
+	long count = 0;
+	while (line < end && *line >= '0' && *line <= '9' && count <= INT_MAX / 2)
+	{
+		count = count * 10 + (*line - '0');
+		line++;
+	}
+
+	*p = next_line(line, end);
+
+	// There must be room for two nodes per edge
+	return count <= INT_MAX / 2 ? (int)count : 0;
+}
+
+/**
+ * read_edges() - Insert the edges of a map into a graph.
+ * @g: Graph to manipulate.
+ * @p: Start of the first line after the number of edges.
+ * @end: End of the file.
+ * @max_nodes: Number of nodes the graph has room for.
+ *
+ * Returns: true if all edges were inserted, false if the map is not
+ * valid.
+ */
+static bool read_edges(graph *g, const char *p, const char *end, int max_nodes)
+{
+	while (p < end)
+	{
+		const char *line = p;
+
+		// Skip comments and empty lines
+		if (*line == '#' || *line == '\n')
+		{
+			p = next_line(line, end);
+			continue;
+		}
+
+		struct name_slice src, dest;
+		p = scan_line(line, end, &src, &dest);
+
+		if (!names_are_valid(&src, &dest))
+		{
+			report_line(line, end);
+			return false;
+		}
+
+		node *n1 = find_or_insert_node(g, &src, max_nodes);
+		node *n2 = find_or_insert_node(g, &dest, max_nodes);
+		if (n1 == NULL || n2 == NULL)
+		{
+			report_full();
+			return false;
+		}
+		graph_insert_edge(g, n1, n2);
+	}
+
+	return true;
+}
+
+// =================== PARALLEL LOADING ======================
+
+/**
+ * intern_ref() - Return the reference to an entry of the intern table.
+ * @shard: Number of the shard.
+ * @index: Index of the entry in the shard.
+ *
+ * Returns: A single int identifying the entry.
+ */
+static int intern_ref(int shard, int index)
+{
+	return index * MAP_SHARDS + shard;
+}
+
+/**
+ * intern_entry() - Return the entry of the intern table for a reference.
+ * @shards: The shards of the table.
+ * @ref: Reference from intern_ref().
+ *
+ * Returns: A pointer to the entry.
+ */
+static struct intern_entry *intern_entry(struct intern_shard *shards, int ref)
+{
+	return &shards[ref % MAP_SHARDS].entries[ref / MAP_SHARDS];
+}
+
+/**
+ * shard_grow() - Double the number of slots of a shard.
+ * @sh: Shard to grow.
+ *
+ * Returns: Nothing.
+ */
+static void shard_grow(struct intern_shard *sh)
+{
+	free(sh->slots);
+	sh->slot_capacity *= 2;
+	sh->slots = malloc(sh->slot_capacity * sizeof(int));
+	for (int i = 0; i < sh->slot_capacity; i++)
+	{
+		sh->slots[i] = -1;
+	}
+
+	int mask = sh->slot_capacity - 1;
+	for (int e = 0; e < sh->count; e++)
+	{
+		int i = (int)((sh->entries[e].hash / MAP_SHARDS) & (unsigned long)mask);
+		while (sh->slots[i] != -1)
+		{
+			i = (i + 1) & mask;
+		}
+		sh->slots[i] = e;
+	}
+}
+
+/**
+ * intern() - Intern a name.
+ * @shards: The shards of the table.
+ * @end: Name to intern.
+ * @pos: Position of the name in the file.
+ *
+ * Returns: The reference to the entry of the name.
+ */
+static int intern(struct intern_shard *shards, const struct edge_end *end, long pos)
+{
+	unsigned long hash = name_hash(end->s, end->len);
+	int shard = (int)(hash & (MAP_SHARDS - 1));
+	struct intern_shard *sh = &shards[shard];
+
+	pthread_mutex_lock(&sh->lock);
+
+	int mask = sh->slot_capacity - 1;
+	int i = (int)((hash / MAP_SHARDS) & (unsigned long)mask);
+	while (sh->slots[i] != -1)
+	{
+		struct intern_entry *e = &sh->entries[sh->slots[i]];
+		if (e->hash == hash && e->len == end->len && memcmp(e->s, end->s, end->len) == 0)
+		{
+			break;
+		}
+		i = (i + 1) & mask;
+	}
+
+	int index = sh->slots[i];
+	if (index == -1)
+	{
+		if (sh->count == sh->capacity)
+		{
+			sh->capacity *= 2;
+			sh->entries = realloc(sh->entries, sh->capacity * sizeof(struct intern_entry));
+		}
+		index = sh->count++;
+		sh->entries[index] = (struct intern_entry){end->s, end->len, hash, pos, NULL};
+		sh->slots[i] = index;
+		if (2 * sh->count >= sh->slot_capacity)
+		{
+			shard_grow(sh);
+		}
+	}
+	else if (pos < sh->entries[index].first)
+	{
+		sh->entries[index].first = pos;
+	}
+
+	pthread_mutex_unlock(&sh->lock);
+
+	return intern_ref(shard, index);
+}
+
+/**
+ * scan_chunk() - Scan the edges of a chunk.
+ * @data: The struct chunk to scan.
+ *
+ * Used as the start function of the threads in step 1. Stops at the
+ * first invalid line.
+ *
+ * Returns: NULL.
+ */
+static void *scan_chunk(void *data)
+{
+	struct chunk *ch = data;
+	const char *p = ch->start;
+
+	while (p < ch->end)
+	{
+		const char *line = p;
+
+		// Skip comments and empty lines
+		if (*line == '#' || *line == '\n')
+		{
+			p = next_line(line, ch->end);
+			continue;
+		}
+
+		struct name_slice src, dest;
+		p = scan_line(line, ch->end, &src, &dest);
+
+		if (!names_are_valid(&src, &dest))
+		{
+			ch->error_line = line;
+			break;
+		}
+
+		if (ch->edge_count == ch->capacity)
+		{
+			ch->capacity *= 2;
+			ch->ends = realloc(ch->ends, 2 * ch->capacity * sizeof(struct edge_end));
+		}
+		struct edge_end *ends = &ch->ends[2 * ch->edge_count++];
+		ends[0] = (struct edge_end){src.s, (int)src.len, -1};
+		ends[1] = (struct edge_end){dest.s, (int)dest.len, -1};
+	}
+
+	return NULL;
+}
+
+/**
+ * intern_chunk() - Intern the names of a chunk.
+ * @data: The struct chunk to intern.
+ *
+ * Used as the start function of the threads in step 2.
+ *
+ * Returns: NULL.
+ */
+static void *intern_chunk(void *data)
+{
+	struct chunk *ch = data;
+
+	for (int i = 0; i < 2 * ch->edge_count; i++)
+	{
+		ch->ends[i].ref = intern(ch->shards, &ch->ends[i], 2 * ch->first_edge + i);
+	}
+
+	return NULL;
+}
+
+/**
+ * run_chunks() - Run a function on every chunk, one thread per chunk.
+ * @chunks: The chunks.
+ * @count: Number of chunks.
+ * @func: Function to run.
+ *
+ * The first chunk is handled by the calling thread.
+ *
+ * Returns: Nothing.
+ */
+static void run_chunks(struct chunk *chunks, int count, void *(*func)(void *))
+{
+	for (int t = 1; t < count; t++)
+	{
+		pthread_create(&chunks[t].thread, NULL, func, &chunks[t]);
+	}
+	func(&chunks[0]);
+	for (int t = 1; t < count; t++)
+	{
+		pthread_join(chunks[t].thread, NULL);
+	}
+}
+
+/**
+ * read_edges_parallel() - Insert the edges of a map into a graph,
+ * scanning them with several threads.
+ * @g: Graph to manipulate.
+ * @p: Start of the first line after the number of edges.
+ * @end: End of the file.
+ * @max_nodes: Number of nodes the graph has room for.
+ * @threads: Number of threads, at least 2.
+ *
+ * Returns: true if all edges were inserted, false if the map is not
+ * valid.
+ */
+static bool read_edges_parallel(graph *g, const char *p, const char *end, int max_nodes, int threads)
+{
+	struct chunk *chunks = calloc(threads, sizeof(struct chunk));
+	struct intern_shard shards[MAP_SHARDS];
+	size_t size = end - p;
+
+	// Split the edges at the first newline after every 1/threads of
+	// the bytes
+	for (int t = 0; t < threads; t++)
+	{
+		const char *start = p + size * t / threads;
+		chunks[t].start = t == 0 ? p : next_line(start - 1, end);
+		chunks[t].capacity = (int)(size / threads / 16) + 16;
+		chunks[t].ends = malloc(2 * chunks[t].capacity * sizeof(struct edge_end));
+		chunks[t].shards = shards;
+	}
+	for (int t = 0; t < threads; t++)
+	{
+		chunks[t].end = t + 1 < threads ? chunks[t + 1].start : end;
+	}
+
+	// Step 1: scan
+	run_chunks(chunks, threads, scan_chunk);
+
+	// Only the edges before the first invalid line are loaded
+	int used = threads;
+	long edge_count = 0;
+	for (int t = 0; t < used; t++)
+	{
+		chunks[t].first_edge = edge_count;
+		edge_count += chunks[t].edge_count;
+		if (chunks[t].error_line != NULL)
+		{
+			used = t + 1;
+		}
+	}
+	const char *error_line = chunks[used - 1].error_line;
+
+	// Step 2: intern
+	for (int i = 0; i < MAP_SHARDS; i++)
+	{
+		struct intern_shard *sh = &shards[i];
+		pthread_mutex_init(&sh->lock, NULL);
+		sh->count = 0;
+		sh->capacity = 64;
+		sh->entries = malloc(sh->capacity * sizeof(struct intern_entry));
+		sh->slot_capacity = 64;
+		sh->slots = NULL;
+		shard_grow(sh);
+	}
+	run_chunks(chunks, used, intern_chunk);
+
+	// Step 3: insert the nodes in order of first appearance. Every
+	// position is the first appearance of at most one name.
+	int *by_first = malloc((2 * edge_count + 1) * sizeof(int));
+	for (long i = 0; i < 2 * edge_count; i++)
+	{
+		by_first[i] = -1;
+	}
+	for (int i = 0; i < MAP_SHARDS; i++)
+	{
+		for (int e = 0; e < shards[i].count; e++)
+		{
+			by_first[shards[i].entries[e].first] = intern_ref(i, e);
+		}
+	}
+
+	bool full = false;
+	for (long i = 0; i < 2 * edge_count && !full; i++)
+	{
+		if (by_first[i] != -1)
+		{
+			struct intern_entry *e = intern_entry(shards, by_first[i]);
+			full = graph_node_count(g) == max_nodes;
+			if (!full)
+			{
+				graph_insert_node_n(g, e->s, e->len);
+				e->n = graph_node_by_id(g, graph_node_count(g) - 1);
+			}
+		}
+	}
+
+	// Step 4: insert the edges. A full graph comes before any invalid
+	// line, which is after every edge.
+	if (full)
+	{
+		report_full();
+	}
+	else
+	{
+		for (int t = 0; t < used; t++)
+		{
+			for (int i = 0; i < 2 * chunks[t].edge_count; i += 2)
+			{
+				graph_insert_edge(g, intern_entry(shards, chunks[t].ends[i].ref)->n,
+						  intern_entry(shards, chunks[t].ends[i + 1].ref)->n);
+			}
+		}
+		if (error_line != NULL)
+		{
+			report_line(error_line, end);
+		}
+	}
+
+	free(by_first);
+	for (int i = 0; i < MAP_SHARDS; i++)
+	{
+		pthread_mutex_destroy(&shards[i].lock);
+		free(shards[i].entries);
+		free(shards[i].slots);
+	}
+	for (int t = 0; t < threads; t++)
+	{
+		free(chunks[t].ends);
+	}
+	free(chunks);
+
+	return !full && error_line == NULL;
+}
+
+// =================== MAP LOADER INTERFACE ======================
+
+/**
+ * map_load() - Load a graph from a map file.
+ * @path: Name of the map file.
+ * @threads: Number of threads to load the map with.
+ *
+ * Returns: A pointer to the new graph, or NULL if the map could not be
+ * loaded.
+ */
+graph *map_load(const char *path, int threads)
+{
+	int fd = open(path, O_RDONLY);
+	struct stat st;
+
+	if (fd < 0 || fstat(fd, &st) != 0)
+	{
+		printf("Error opening file\n");
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+		return NULL;
+	}
+
+	// An empty file cannot be mapped, but has no edges either
+	const char *data = NULL;
+	size_t size = st.st_size;
+	if (size > 0)
+	{
+		data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED)
+		{
+			printf("Error opening file\n");
+			close(fd);
+			return NULL;
+		}
+		posix_madvise((void *)data, size, POSIX_MADV_SEQUENTIAL);
+	}
+	close(fd);
+
+	init_char_class();
+
+	const char *p = data;
+	const char *end = data + size;
+	int edge_count = read_edge_count(&p, end);
+	graph *g = NULL;
+
+	if (edge_count == 0)
+	{
+		printf("ERROR: Number of edges was not added \n");
+	}
+	else
+	{
+		// Use fewer threads if the chunks would be small, and no
+		// more than there are processors to run them
+		size_t max_threads = (end - p) / MAP_CHUNK_MIN;
+		long processors = sysconf(_SC_NPROCESSORS_ONLN);
+		if (processors > 0 && (size_t)processors < max_threads)
+		{
+			max_threads = processors;
+		}
+		if ((size_t)threads > max_threads)
+		{
+			threads = max_threads > 0 ? (int)max_threads : 1;
+		}
+
+		g = graph_empty(2 * edge_count);
+		bool ok = threads > 1 ? read_edges_parallel(g, p, end, 2 * edge_count, threads) : read_edges(g, p, end, 2 * edge_count);
+		if (!ok)
+		{
+			graph_kill(g);
+			g = NULL;
+		}
+	}
+
+	if (data != NULL)
+	{
+		munmap((void *)data, size);
+	}
+
+	return g;
+}
@@ -0,0 +1,50 @@
+#ifndef __MAP_LOADER_H
+#define __MAP_LOADER_H
+
+#include "graph.h"
+
+/*
+ * Loader for map files. A map file describes a directed graph:
+ *
+ *   # Lines starting with # are comments and are skipped, as are
+ *   # empty lines.
+ *   3                    <- number of edges, the first line that
+ *                           starts with a digit
+ *   A B                  <- one edge per line, origin and destination
+ *   B C # comment        <- anything after the two names is ignored
+ *   C A
+ *
+ * Node names are alphanumeric and at most MAP_MAX_NAME_LENGTH
+ * characters long. The file is mapped into memory and scanned in
+ * place, and the names are passed to the graph as slices of the
+ * mapped file, so nothing is copied until a node is created. A large
+ * map can be loaded by several threads.
+ *
+ * Authors: Adam Pettersson
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first public version.
+ *   2026-10-16: v1.1, threads argument to map_load().
+ */
+
+#define MAP_MAX_NAME_LENGTH 40
+
+// ====================== MAP LOADER INTERFACE ==========================
+
+/**
+ * map_load() - Load a graph from a map file.
+ * @path: Name of the map file.
+ * @threads: Number of threads to load the map with. Fewer are used if
+ *	     the map is too small to gain from them.
+ *
+ * The graph has room for two nodes per edge given in the file, and the
+ * nodes are inserted in the order they first appear, whatever the
+ * number of threads. If the file cannot be read or is not a valid map,
+ * an error message is printed on standard output.
+ *
+ * Returns: A pointer to the new graph, or NULL if the map could not be
+ * loaded.
+ */
+graph *map_load(const char *path, int threads);
+
+#endif
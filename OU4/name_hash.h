@@ -0,0 +1,36 @@
+#ifndef __NAME_HASH_H
+#define __NAME_HASH_H
+
+#include <stddef.h>
+
+/*
+ * Hash function for node names, shared by the graph and everything
+ * that indexes node names, so that a name hashes to the same value
+ * everywhere.
+ *
+ * Authors: Adam Pettersson
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first public version.
+ */
+
+/**
+ * name_hash() - Compute the hash value of a node name (FNV-1a).
+ * @s: Node name. Does not have to be '\0'-terminated.
+ * @len: Number of characters in the name.
+ *
+ * Returns: The hash value.
+ */
+static inline unsigned long name_hash(const char *s, size_t len)
+{
+	unsigned long h = 2166136261UL;
+
+	for (size_t i = 0; i < len; i++)
+	{
+		h = (h ^ (unsigned char)s[i]) * 16777619UL;
+	}
+
+	return h;
+}
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef __PAR_BFS_H
+#define __PAR_BFS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "csr_graph.h"
+
+/*
+ * Level-synchronous parallel breadth first search over a frozen graph.
+ *
+ * The frontier and the set of visited nodes are bitmaps indexed by node
+ * id. Each level is expanded either top-down (the threads follow the
+ * edges out of the frontier and claim unvisited nodes with atomic
+ * operations) or bottom-up (every unvisited node looks for a
+ * predecessor in the frontier), whichever is expected to look at fewer
+ * edges. Bottom-up pays off for the few large levels in the middle of a
+ * search of a well connected graph.
+ *
+ * Authors: Adam Pettersson
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first public version.
+ */
+
+/**
+ * par_bfs() - Find the nodes reachable from a node, in parallel.
+ * @c: Frozen graph to search.
+ * @src: Id of the node to start from.
+ * @target: Id of a node to stop at as soon as it has been reached, or
+ *	    -1 to find every reachable node.
+ * @threads: Number of threads to search with.
+ * @reached: Bitmap of (node_count + 63) / 64 words, or NULL. If given,
+ *	     bit id is set for every node reached from src by a path
+ *	     with at least one edge. If the search stopped at target,
+ *	     the bitmap only holds the nodes reached until then.
+ *
+ * src itself only counts as reached if it is on a cycle, as in
+ * is_connected.
+ *
+ * Returns: true if target was reached, otherwise false.
+ */
+bool par_bfs(const csr_graph *c, int src, int target, int threads, uint64_t *reached);
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef __REACH_CLOSURE_H
+#define __REACH_CLOSURE_H
+
+#include <stdbool.h>
+#include "reach_index.h"
+
+/*
+ * Transitive closure of the condensation of a graph, stored as one
+ * row of packed 64-bit words per component: bit b of row a is set if
+ * component a reaches component b. A query is then a single bit test.
+ *
+ * The closure takes (components^2)/8 bytes, so it is meant for graphs
+ * with up to a few tens of thousands of components.
+ *
+ * Authors: Adam Pettersson
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first public version.
+ */
+
+// ====================== PUBLIC DATA TYPES ==========================
+
+// Anonymous declaration of reach_closure.
+typedef struct reach_closure reach_closure;
+
+// ==================== REACH CLOSURE INTERFACE ==========================
+
+/**
+ * reach_closure_build() - Build the transitive closure of an index.
+ * @r: Reachability index with the condensation.
+ *
+ * The closure uses the component ids of r, so r must not be killed
+ * before the closure.
+ *
+ * Returns: A pointer to the new closure.
+ */
+reach_closure *reach_closure_build(const reach_index *r);
+
+/**
+ * reach_closure_query() - Check if there is a path between two nodes.
+ * @cl: Closure to query.
+ * @src: Id of the source node.
+ * @dest: Id of the destination node.
+ *
+ * Gives the same answer as reach_index_query(), but does not change
+ * any state, so a closure may be queried by several threads at once.
+ *
+ * Returns: true if there is a path with at least one edge from src to
+ * dest, otherwise false.
+ */
+bool reach_closure_query(const reach_closure *cl, int src, int dest);
+
+/**
+ * reach_closure_kill() - Destroy a closure.
+ * @cl: Closure to destroy.
+ *
+ * Returns: Nothing.
+ */
+void reach_closure_kill(reach_closure *cl);
+
+#endif
@@ -0,0 +1,597 @@
+/*
+ * Reachability index built from the strongly connected components of
+ * a frozen graph.
+ *
+ * The components are found with an iterative version of Tarjan's
+ * algorithm, so deep graphs do not overflow the call stack. Tarjan's
+ * algorithm completes the components in reverse topological order, so
+ * the ids are flipped afterwards to number them in topological order.
+ * The condensation is stored in CSR form like the frozen graph, with
+ * the edges between each pair of components merged into one.
+ *
+ * Each component also gets labels that answer most queries between
+ * components without a search:
+ *
+ *   level     Length of the longest path from the component to a sink.
+ *	       A component only reaches components with a lower level.
+ *   pre, post Numbers from a depth first search of the condensation. b
+ *	       is below a in the search tree, and so reachable from a,
+ *	       if pre[a] <= pre[b] and post[b] <= post[a].
+ *   low       The lowest post number of any component reachable from
+ *	       the component, itself included. If a reaches b, then
+ *	       [low[b], post[b]] lies within [low[a], post[a]].
+ *
+ * Only a query that none of the labels decide needs a search, and the
+ * search skips every component whose labels rule out b.
+ *
+ * Authors: Adam Pettersson
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first public version.
+ *   2026-10-16: v1.1, reach_visit for queries from several threads.
+ *   2026-10-16: v1.2, reachability labels.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include "csr_graph.h"
+#include "reach_index.h"
+
+/*
+ * own is the search state used by reach_index_query().
+ */
+struct reach_index
+{
+	int node_count;
+	int comp_count;
+	int *comp;	// Component of each node
+	bool *cyclic;	// Per component
+	int *offsets;	// comp_count + 1 entries
+	int *targets;	// Condensation edges
+	int *level;	// Per component, see the labels above
+	int *pre;
+	int *post;
+	int *low;
+	reach_visit *own;
+};
+
+/*
+ * State of the search in a query. A component has been visited in the
+ * current query if visited[comp] equals epoch, so the array never has
+ * to be cleared between queries.
+ */
+struct reach_visit
+{
+	int size;
+	unsigned int *visited;
+	int *stack;
+	unsigned int epoch;
+};
+
+// =================== INTERNAL FUNCTIONS ======================
+
+/**
+ * find_components() - Find the strongly connected components of a graph.
+ * @r: Index to fill in. comp and cyclic must be allocated.
+ * @c: Frozen graph.
+ *
+ * Sets comp_count, the component of every node (in the order Tarjan's
+ * algorithm completes them) and the cyclic flag of every component.
+ *
+ * Returns: Nothing.
+ */
+static void find_components(reach_index *r, const csr_graph *c)
+{
+	int n = r->node_count;
+	int *index = malloc(n * sizeof(int));
+	int *low = malloc(n * sizeof(int));
+	int *scc_stack = malloc(n * sizeof(int));
+	int *call_node = malloc(n * sizeof(int));
+	int *call_edge = malloc(n * sizeof(int));
+	bool *self_loop = calloc(n, sizeof(bool));
+	int counter = 0;
+	int scc_top = 0;
+
+	for (int v = 0; v < n; v++)
+	{
+		index[v] = -1;
+		r->comp[v] = -1;
+	}
+	r->comp_count = 0;
+
+	for (int root = 0; root < n; root++)
+	{
+		if (index[root] != -1)
+		{
+			continue;
+		}
+
+		// Start a depth first search from root. call_node/call_edge
+		// is the explicit call stack: the node and how many of its
+		// edges have been followed.
+		int call_top = 0;
+		index[root] = low[root] = counter++;
+		scc_stack[scc_top++] = root;
+		call_node[call_top] = root;
+		call_edge[call_top++] = 0;
+
+		while (call_top > 0)
+		{
+			int v = call_node[call_top - 1];
+			int degree;
+			const int *neighbours = csr_graph_neighbours(c, v, &degree);
+
+			if (call_edge[call_top - 1] < degree)
+			{
+				int w = neighbours[call_edge[call_top - 1]++];
+
+				if (w == v)
+				{
+					self_loop[v] = true;
+				}
+				if (index[w] == -1)
+				{
+					// Descend into w
+					index[w] = low[w] = counter++;
+					scc_stack[scc_top++] = w;
+					call_node[call_top] = w;
+					call_edge[call_top++] = 0;
+				}
+				else if (r->comp[w] == -1 && index[w] < low[v])
+				{
+					// w is on the SCC stack
+					low[v] = index[w];
+				}
+				continue;
+			}
+
+			// All edges of v are done, return from v
+			call_top--;
+			if (low[v] == index[v])
+			{
+				// v is the root of a component. Pop it off the stack.
+				int size = 0;
+				int w;
+				do
+				{
+					w = scc_stack[--scc_top];
+					r->comp[w] = r->comp_count;
+					size++;
+				} while (w != v);
+				r->cyclic[r->comp_count] = size > 1 || self_loop[v];
+				r->comp_count++;
+			}
+			if (call_top > 0)
+			{
+				int u = call_node[call_top - 1];
+				if (low[v] < low[u])
+				{
+					low[u] = low[v];
+				}
+			}
+		}
+	}
+
+	free(index);
+	free(low);
+	free(scc_stack);
+	free(call_node);
+	free(call_edge);
+	free(self_loop);
+}
+
+/**
+ * build_condensation() - Build the condensation of a graph.
+ * @r: Index with the components found.
+ * @c: Frozen graph.
+ *
+ * Renumbers the components in topological order and fills in the
+ * condensation edges.
+ *
+ * Returns: Nothing.
+ */
+static void build_condensation(reach_index *r, const csr_graph *c)
+{
+	int n = r->node_count;
+	int comps = r->comp_count;
+
+	// Flip the ids into topological order, including the cyclic flags
+	for (int v = 0; v < n; v++)
+	{
+		r->comp[v] = comps - 1 - r->comp[v];
+	}
+	for (int i = 0; i < comps / 2; i++)
+	{
+		bool tmp = r->cyclic[i];
+		r->cyclic[i] = r->cyclic[comps - 1 - i];
+		r->cyclic[comps - 1 - i] = tmp;
+	}
+
+	// Sort the nodes by component (counting sort)
+	int *first = calloc(comps + 1, sizeof(int));
+	int *members = malloc((n > 0 ? n : 1) * sizeof(int));
+	for (int v = 0; v < n; v++)
+	{
+		first[r->comp[v] + 1]++;
+	}
+	for (int a = 0; a < comps; a++)
+	{
+		first[a + 1] += first[a];
+	}
+	int *fill = malloc((comps > 0 ? comps : 1) * sizeof(int));
+	for (int a = 0; a < comps; a++)
+	{
+		fill[a] = first[a];
+	}
+	for (int v = 0; v < n; v++)
+	{
+		members[fill[r->comp[v]]++] = v;
+	}
+
+	// Two passes over the edges of each component: count the distinct
+	// successors, then store them. last[b] == a marks that the edge
+	// a->b has already been seen.
+	int *last = fill;
+	r->offsets = malloc((comps + 1) * sizeof(int));
+	r->offsets[0] = 0;
+	r->targets = NULL;
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (int a = 0; a < comps; a++)
+		{
+			last[a] = -1;
+		}
+		if (pass == 1)
+		{
+			r->targets = malloc((r->offsets[comps] > 0 ? r->offsets[comps] : 1) * sizeof(int));
+		}
+
+		for (int a = 0; a < comps; a++)
+		{
+			int edges = 0;
+			for (int i = first[a]; i < first[a + 1]; i++)
+			{
+				int degree;
+				const int *neighbours = csr_graph_neighbours(c, members[i], &degree);
+
+				for (int e = 0; e < degree; e++)
+				{
+					int b = r->comp[neighbours[e]];
+					if (b != a && last[b] != a)
+					{
+						last[b] = a;
+						if (pass == 1)
+						{
+							r->targets[r->offsets[a] + edges] = b;
+						}
+						edges++;
+					}
+				}
+			}
+			if (pass == 0)
+			{
+				r->offsets[a + 1] = r->offsets[a] + edges;
+			}
+		}
+	}
+
+	free(first);
+	free(members);
+	free(fill);
+}
+
+/**
+ * build_labels() - Compute the reachability labels of the components.
+ * @r: Index with the condensation built.
+ *
+ * Returns: Nothing.
+ */
+static void build_labels(reach_index *r)
+{
+	int comps = r->comp_count;
+	int size = comps > 0 ? comps : 1;
+	r->level = malloc(size * sizeof(int));
+	r->pre = malloc(size * sizeof(int));
+	r->post = malloc(size * sizeof(int));
+	r->low = malloc(size * sizeof(int));
+
+	// Depth first search of the condensation, with an explicit stack
+	// of components and how many of their edges have been followed
+	int *call_comp = malloc(size * sizeof(int));
+	int *call_edge = malloc(size * sizeof(int));
+	int pre_counter = 0;
+	int post_counter = 0;
+
+	for (int a = 0; a < comps; a++)
+	{
+		r->pre[a] = -1;
+	}
+	for (int root = 0; root < comps; root++)
+	{
+		if (r->pre[root] != -1)
+		{
+			continue;
+		}
+
+		int call_top = 0;
+		r->pre[root] = pre_counter++;
+		call_comp[call_top] = root;
+		call_edge[call_top++] = r->offsets[root];
+		while (call_top > 0)
+		{
+			int x = call_comp[call_top - 1];
+
+			if (call_edge[call_top - 1] < r->offsets[x + 1])
+			{
+				int y = r->targets[call_edge[call_top - 1]++];
+				if (r->pre[y] == -1)
+				{
+					r->pre[y] = pre_counter++;
+					call_comp[call_top] = y;
+					call_edge[call_top++] = r->offsets[y];
+				}
+				continue;
+			}
+
+			r->post[x] = post_counter++;
+			call_top--;
+		}
+	}
+	free(call_comp);
+	free(call_edge);
+
+	// Successors have higher ids, so going from the highest id down
+	// they are always done first
+	for (int a = comps - 1; a >= 0; a--)
+	{
+		r->level[a] = 0;
+		r->low[a] = r->post[a];
+		for (int e = r->offsets[a]; e < r->offsets[a + 1]; e++)
+		{
+			int b = r->targets[e];
+			if (r->level[b] + 1 > r->level[a])
+			{
+				r->level[a] = r->level[b] + 1;
+			}
+			if (r->low[b] < r->low[a])
+			{
+				r->low[a] = r->low[b];
+			}
+		}
+	}
+}
+
+/**
+ * may_reach() - Check if the labels allow a path between components.
+ * @r: Index to inspect.
+ * @a: Component to start from.
+ * @b: Component to reach, a != b.
+ *
+ * Returns: false if the labels rule out a path from a to b, otherwise
+ * true.
+ */
+static bool may_reach(const reach_index *r, int a, int b)
+{
+	return a < b && r->level[a] > r->level[b] &&
+	       r->low[a] <= r->low[b] && r->post[b] < r->post[a];
+}
+
+/**
+ * tree_reaches() - Check if a component is below another in the search
+ * tree of the labels.
+ * @r: Index to inspect.
+ * @a: Component to start from.
+ * @b: Component to reach.
+ *
+ * Returns: true if b is below a in the tree, and so reachable from a.
+ */
+static bool tree_reaches(const reach_index *r, int a, int b)
+{
+	return r->pre[a] <= r->pre[b] && r->post[b] <= r->post[a];
+}
+
+// =================== REACH INDEX INTERFACE ======================
+
+/**
+ * reach_index_build() - Build the reachability index of a frozen graph.
+ * @c: Frozen graph to index.
+ *
+ * Returns: A pointer to the new index.
+ */
+reach_index *reach_index_build(const csr_graph *c)
+{
+	reach_index *r = calloc(1, sizeof(reach_index));
+	r->node_count = csr_graph_node_count(c);
+	int n = r->node_count > 0 ? r->node_count : 1;
+	r->comp = malloc(n * sizeof(int));
+	r->cyclic = malloc(n * sizeof(bool));
+
+	find_components(r, c);
+	build_condensation(r, c);
+	build_labels(r);
+
+	r->own = reach_visit_empty(r);
+
+	return r;
+}
+
+/**
+ * reach_index_query() - Check if there is a path between two nodes.
+ * @r: Index to query.
+ * @src: Id of the source node.
+ * @dest: Id of the destination node.
+ *
+ * Returns: true if there is a path with at least one edge from src to
+ * dest, otherwise false.
+ */
+bool reach_index_query(reach_index *r, int src, int dest)
+{
+	return reach_index_query_visit(r, r->own, src, dest);
+}
+
+/**
+ * reach_visit_empty() - Create search state for queries on an index.
+ * @r: Index to create the state for.
+ *
+ * Returns: A pointer to the new search state.
+ */
+reach_visit *reach_visit_empty(const reach_index *r)
+{
+	reach_visit *v = malloc(sizeof(reach_visit));
+	v->size = r->comp_count > 0 ? r->comp_count : 1;
+	v->visited = calloc(v->size, sizeof(unsigned int));
+	v->stack = malloc(v->size * sizeof(int));
+	v->epoch = 0;
+
+	return v;
+}
+
+/**
+ * reach_index_query_visit() - Check if there is a path between two nodes.
+ * @r: Index to query.
+ * @v: Search state to use.
+ * @src: Id of the source node.
+ * @dest: Id of the destination node.
+ *
+ * Returns: true if there is a path with at least one edge from src to
+ * dest, otherwise false.
+ */
+bool reach_index_query_visit(const reach_index *r, reach_visit *v, int src, int dest)
+{
+	int a = r->comp[src];
+	int b = r->comp[dest];
+
+	// Within a component every node reaches every node, itself
+	// included, exactly when the component has a cycle
+	if (a == b)
+	{
+		return r->cyclic[a];
+	}
+
+	// Answer from the labels if they decide the query
+	if (!may_reach(r, a, b))
+	{
+		return false;
+	}
+	if (tree_reaches(r, a, b))
+	{
+		return true;
+	}
+
+	// Search from a, skipping components whose labels rule out b
+	v->epoch++;
+	if (v->epoch == 0)
+	{
+		for (int i = 0; i < v->size; i++)
+		{
+			v->visited[i] = 0;
+		}
+		v->epoch = 1;
+	}
+
+	int top = 0;
+	v->stack[top++] = a;
+	v->visited[a] = v->epoch;
+	while (top > 0)
+	{
+		int x = v->stack[--top];
+
+		for (int e = r->offsets[x]; e < r->offsets[x + 1]; e++)
+		{
+			int y = r->targets[e];
+			if (y == b || (v->visited[y] != v->epoch && tree_reaches(r, y, b)))
+			{
+				return true;
+			}
+			if (v->visited[y] != v->epoch && may_reach(r, y, b))
+			{
+				v->visited[y] = v->epoch;
+				v->stack[top++] = y;
+			}
+		}
+	}
+
+	return false;
+}
+
+/**
+ * reach_visit_kill() - Destroy search state.
+ * @v: Search state to destroy.
+ *
+ * Returns: Nothing.
+ */
+void reach_visit_kill(reach_visit *v)
+{
+	free(v->visited);
+	free(v->stack);
+	free(v);
+}
+
+/**
+ * reach_index_component_count() - Return the number of components.
+ * @r: Index to inspect.
+ *
+ * Returns: The number of strongly connected components.
+ */
+int reach_index_component_count(const reach_index *r)
+{
+	return r->comp_count;
+}
+
+/**
+ * reach_index_component() - Return the component of a node.
+ * @r: Index to inspect.
+ * @id: Node id.
+ *
+ * Returns: The component id, in topological order.
+ */
+int reach_index_component(const reach_index *r, int id)
+{
+	return r->comp[id];
+}
+
+/**
+ * reach_index_is_cyclic() - Check if a component contains a cycle.
+ * @r: Index to inspect.
+ * @comp: Component id.
+ *
+ * Returns: true if the nodes of the component reach each other.
+ */
+bool reach_index_is_cyclic(const reach_index *r, int comp)
+{
+	return r->cyclic[comp];
+}
+
+/**
+ * reach_index_successors() - Return the successors of a component.
+ * @r: Index to inspect.
+ * @comp: Component id.
+ * @count: Set to the number of successors.
+ *
+ * Returns: A pointer to the ids of the successors, *count entries long.
+ */
+const int *reach_index_successors(const reach_index *r, int comp, int *count)
+{
+	*count = r->offsets[comp + 1] - r->offsets[comp];
+	return r->targets + r->offsets[comp];
+}
+
+/**
+ * reach_index_kill() - Destroy a reachability index.
+ * @r: Index to destroy.
+ *
+ * Returns: Nothing.
+ */
+void reach_index_kill(reach_index *r)
+{
+	free(r->comp);
+	free(r->cyclic);
+	free(r->offsets);
+	free(r->targets);
+	free(r->level);
+	free(r->pre);
+	free(r->post);
+	free(r->low);
+	reach_visit_kill(r->own);
+	free(r);
+}
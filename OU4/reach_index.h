@@ -0,0 +1,151 @@
+#ifndef __REACH_INDEX_H
+#define __REACH_INDEX_H
+
+#include <stdbool.h>
+#include "csr_graph.h"
+
+/*
+ * Reachability index over a frozen graph. The strongly connected
+ * components (SCCs) of the graph are found with Tarjan's algorithm and
+ * contracted into a directed acyclic graph, the condensation. Two
+ * nodes in the same component reach each other, so a query only has to
+ * search the condensation, which is usually far smaller than the graph.
+ * Every component also has a few labels (its topological level and
+ * intervals from a depth first search of the condensation) that answer
+ * most queries between components by comparing numbers.
+ *
+ * The components are numbered in topological order: every edge of the
+ * condensation goes from a lower to a higher component id.
+ *
+ * As in is_connected, a path must have at least one edge, so a node
+ * only reaches itself if it is on a cycle.
+ *
+ * Authors: Adam Pettersson
+ *
+ * Version information:
+ *   2026-10-16: v1.0, first public version.
+ *   2026-10-16: v1.1, reach_visit for queries from several threads.
+ *   2026-10-16: v1.2, reachability labels.
+ */
+
+// ====================== PUBLIC DATA TYPES ==========================
+
+// Anonymous declarations of reach_index and reach_visit.
+typedef struct reach_index reach_index;
+typedef struct reach_visit reach_visit;
+
+// ==================== REACH INDEX INTERFACE ==========================
+
+/**
+ * reach_index_build() - Build the reachability index of a frozen graph.
+ * @c: Frozen graph to index.
+ *
+ * The index does not refer to c after it has been built.
+ *
+ * Returns: A pointer to the new index.
+ */
+reach_index *reach_index_build(const csr_graph *c);
+
+/**
+ * reach_index_query() - Check if there is a path between two nodes.
+ * @r: Index to query.
+ * @src: Id of the source node.
+ * @dest: Id of the destination node.
+ *
+ * Answered from the component ids when src and dest are in the same
+ * component, and from the labels of the components when they rule a
+ * path out or prove one. Otherwise a depth first search of the
+ * condensation is done, which skips every component whose labels rule
+ * out dest. That search is still a traversal, so the worst case cost of
+ * a query is linear in the size of the condensation. Use reach_closure.h
+ * for queries that are always answered in constant time.
+ *
+ * The search uses state stored in the index, so this function must not
+ * be called by several threads at once. Use reach_index_query_visit()
+ * for that.
+ *
+ * Returns: true if there is a path with at least one edge from src to
+ * dest, otherwise false.
+ */
+bool reach_index_query(reach_index *r, int src, int dest);
+
+/**
+ * reach_visit_empty() - Create search state for queries on an index.
+ * @r: Index to create the state for.
+ *
+ * Returns: A pointer to the new search state.
+ */
+reach_visit *reach_visit_empty(const reach_index *r);
+
+/**
+ * reach_index_query_visit() - Check if there is a path between two nodes.
+ * @r: Index to query.
+ * @v: Search state to use.
+ * @src: Id of the source node.
+ * @dest: Id of the destination node.
+ *
+ * As reach_index_query(), but with the search state in v instead of in
+ * the index. The index is only read, so several threads may query it
+ * at once as long as each has its own search state.
+ *
+ * Returns: true if there is a path with at least one edge from src to
+ * dest, otherwise false.
+ */
+bool reach_index_query_visit(const reach_index *r, reach_visit *v, int src, int dest);
+
+/**
+ * reach_visit_kill() - Destroy search state.
+ * @v: Search state to destroy.
+ *
+ * Returns: Nothing.
+ */
+void reach_visit_kill(reach_visit *v);
+
+/**
+ * reach_index_component_count() - Return the number of components.
+ * @r: Index to inspect.
+ *
+ * Returns: The number of strongly connected components.
+ */
+int reach_index_component_count(const reach_index *r);
+
+/**
+ * reach_index_component() - Return the component of a node.
+ * @r: Index to inspect.
+ * @id: Node id.
+ *
+ * Returns: The component id, in topological order.
+ */
+int reach_index_component(const reach_index *r, int id);
+
+/**
+ * reach_index_is_cyclic() - Check if a component contains a cycle.
+ * @r: Index to inspect.
+ * @comp: Component id.
+ *
+ * Returns: true if the component has more than one node or a node with
+ * an edge to itself, i.e. if its nodes reach each other.
+ */
+bool reach_index_is_cyclic(const reach_index *r, int comp);
+
+/**
+ * reach_index_successors() - Return the successors of a component.
+ * @r: Index to inspect.
+ * @comp: Component id.
+ * @count: Set to the number of successors.
+ *
+ * Returns: A pointer to the ids of the components that comp has an
+ * edge to in the condensation, *count entries long, without
+ * duplicates. All successors have higher ids than comp.
+ */
+const int *reach_index_successors(const reach_index *r, int comp, int *count);
+
+/**
+ * reach_index_kill() - Destroy a reachability index.
+ * @r: Index to destroy.
+ *
+ * Returns: Nothing.
+ */
+void reach_index_kill(reach_index *r);
+
+#endif